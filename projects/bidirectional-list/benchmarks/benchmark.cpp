@@ -0,0 +1,392 @@
+/**
+ * @file benchmark.cpp
+ * @brief Benchmark suite comparing list<T> with std::list, std::deque and std::vector.
+ *
+ * Every operation is measured for int, std::string and person elements on containers of 10^2 up to 10^7 elements.
+ * Results are printed as CSV (one line per measurement), so they can be stored and compared between releases:
+ *     container,type,operation,size,ops,ns_per_op,ops_per_sec,peak_rss_kb
+ * peak_rss_kb is the peak resident set size of the whole process after the measurement.
+ * Operations which are linear per call for a container (e.g. push_front on std::vector) are skipped above 10^5 elements.
+ *
+ * Build (from projects/bidirectional-list):
+ *     g++ -std=c++17 -O2 -I. -pthread benchmarks/benchmark.cpp functions.cpp -o benchmark
+ * Usage:
+ *     benchmark [max size] [container filter] [type filter]
+ * e.g. "benchmark 100000 list person" runs only list<person> up to 10^5 elements ("all" disables a filter).
+ *
+ */
+
+#include "functions.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/** Returns the peak resident set size of the process
+ * @return Peak RSS in kilobytes
+ */
+long peakRssKb()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#elif defined(__APPLE__)
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024;
+#else
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+#endif
+}
+
+/** Measures time of a callable
+ * @param f - callable to measure
+ * @return Time in nanoseconds
+ */
+template <class F>
+double measure(F f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+/** Value kept in the containers, so that the compiler cannot drop the measured loops*/
+volatile size_t sink = 0;
+
+/** Creates i-th test element*/
+template <class T>
+T makeValue(size_t i, std::mt19937 &rng);
+
+template <>
+int makeValue<int>(size_t, std::mt19937 &rng)
+{
+	return static_cast<int>(rng() % 1000000);
+}
+
+template <>
+std::string makeValue<std::string>(size_t, std::mt19937 &rng)
+{
+	// Every fourth string is too long for the small string optimization
+	std::string s = "item" + std::to_string(rng() % 1000000);
+	if (rng() % 4 == 0)
+		s += "_with_a_longer_suffix";
+	return s;
+}
+
+template <>
+person makeValue<person>(size_t, std::mt19937 &rng)
+{
+	static const std::string names[] = {"Jan", "Kamil", "Maciej", "Adam", "Anna", "Ewa", "Piotr", "Zofia"};
+	return person(names[rng() % 8], static_cast<int>(rng() % 100));
+}
+
+/** Returns a value depending on the element, used to keep the compiler from dropping loops over the elements*/
+size_t touch(int x) { return static_cast<size_t>(x); }
+size_t touch(const std::string &x) { return x.size(); }
+size_t touch(person &x) { return static_cast<size_t>(x.getAge()); }
+
+/** Creates an element which is never generated by makeValue, so that search has to visit all elements*/
+template <class T>
+T missingValue() { return T(); }
+template <>
+int missingValue<int>() { return -1; }
+template <>
+person missingValue<person>() { return person("", -1); }
+
+/** Returns name of the element type
+ * @return Name used in the CSV output
+ */
+template <class T>
+const char *typeName();
+template <>
+const char *typeName<int>() { return "int"; }
+template <>
+const char *typeName<std::string>() { return "string"; }
+template <>
+const char *typeName<person>() { return "person"; }
+
+/** Prints one CSV line
+ * @param container - name of the container
+ * @param type - name of the element type
+ * @param operation - name of the operation
+ * @param size - number of elements in the container
+ * @param ops - number of measured operations
+ * @param ns - total time in nanoseconds
+ */
+void report(const char *container, const char *type, const char *operation, size_t size, size_t ops, double ns)
+{
+	double perOp = ops == 0 ? 0 : ns / ops;
+	double perSecond = ns == 0 ? 0 : ops * 1e9 / ns;
+	std::printf("%s,%s,%s,%zu,%zu,%.2f,%.0f,%ld\n", container, type, operation, size, ops, perOp, perSecond, peakRssKb());
+	std::fflush(stdout);
+}
+
+/** Trait telling apart list<T> from the standard containers*/
+template <class C>
+struct isOurList : std::false_type
+{
+};
+template <class T>
+struct isOurList<list<T>> : std::true_type
+{
+};
+
+/** Returns number of elements in a container*/
+template <class C>
+size_t sizeOf(C &c)
+{
+	if constexpr (isOurList<C>::value)
+		return c.getSize();
+	else
+		return c.size();
+}
+
+/** Removes first element of a standard container*/
+template <class C>
+void popFront(C &c)
+{
+	if constexpr (std::is_same<C, std::vector<typename C::value_type>>::value)
+		c.erase(c.begin());
+	else
+		c.pop_front();
+}
+
+/** Adds element at the beginning of a standard container*/
+template <class C, class T>
+void pushFront(C &c, const T &elem)
+{
+	if constexpr (std::is_same<C, std::vector<T>>::value)
+		c.insert(c.begin(), elem);
+	else
+		c.push_front(elem);
+}
+
+/** Runs all operations for one container, element type and size
+ * @param name - name of the container
+ * @param size - number of elements
+ * @param values - elements to insert
+ */
+template <class C, class T>
+void runCase(const char *name, size_t size, const std::vector<T> &values)
+{
+	constexpr bool ours = isOurList<C>::value;
+	constexpr bool vector = std::is_same<C, std::vector<T>>::value;
+	const char *type = typeName<T>();
+	const size_t linearLimit = 100000;
+
+	C c;
+	report(name, type, "push_back", size, size, measure([&]
+														  { for (size_t i = 0; i < size; i++) c.push_back(values[i]); }));
+	{
+		C bulk;
+		double ns;
+		if constexpr (ours)
+			ns = measure([&]
+						 { bulk.append(values.begin(), values.begin() + size); });
+		else
+			ns = measure([&]
+						 { bulk.insert(bulk.end(), values.begin(), values.begin() + size); });
+		report(name, type, "append_range", size, size, ns);
+	}
+	report(name, type, "iterate", size, size, measure([&]
+														{ size_t n = 0; for (auto &x : c) n += touch(x); sink = n; }));
+	{
+		T missing = missingValue<T>();
+		size_t found = 0;
+		double ns;
+		if constexpr (ours)
+			ns = measure([&]
+						 { found = c.find(missing) != c.end(); });
+		else
+			ns = measure([&]
+						 { found = std::find(c.begin(), c.end(), missing) != c.end(); });
+		sink = found;
+		report(name, type, "search", size, size, ns);
+	}
+	{
+		// Results are destroyed outside of the measured callables
+		std::unique_ptr<C> another, moved;
+		report(name, type, "copy_construct", size, size, measure([&]
+																  { another.reset(new C(c)); }));
+		report(name, type, "move_construct", size, 1, measure([&]
+															   { moved.reset(new C(std::move(*another))); }));
+		sink = sizeOf(*moved);
+	}
+	{
+		C copy(c);
+		double ns;
+		if constexpr (ours)
+			ns = measure([&]
+						 { copy.sort(); });
+		else if constexpr (std::is_same<C, std::list<T>>::value)
+			ns = measure([&]
+						 { copy.sort(); });
+		else
+			ns = measure([&]
+						 { std::sort(copy.begin(), copy.end()); });
+		report(name, type, "sort", size, size, ns);
+	}
+	if constexpr (ours)
+	{
+		// Sorting only relinks nodes, traversal jumps around memory until compact() lays them out in order
+		C scattered(c);
+		scattered.sort();
+		report(name, type, "iterate_sorted", size, size, measure([&]
+																  { size_t n = 0; for (auto &x : scattered) n += touch(x); sink = n; }));
+		report(name, type, "compact", size, size, measure([&]
+														   { scattered.compact(0); }));
+		report(name, type, "iterate_compacted", size, size, measure([&]
+																	 { size_t n = 0; for (auto &x : scattered) n += touch(x); sink = n; }));
+	}
+	{
+		size_t removals = std::min<size_t>(size / 2, 1000);
+		C copy(c);
+		double ns;
+		if constexpr (ours)
+			ns = measure([&]
+						 { for (size_t i = 0; i < removals; i++) { T removed = copy.pop_specified_position(static_cast<int>(copy.getSize() / 2)); sink = touch(removed); } });
+		else
+			ns = measure([&]
+						 { for (size_t i = 0; i < removals; i++) { auto it = copy.begin(); std::advance(it, copy.size() / 2); copy.erase(it); } });
+		report(name, type, "positional_remove", size, removals, ns);
+	}
+	{
+		const char *fileName = "benchmark_tmp";
+		double saveNs, openNs;
+		if constexpr (ours)
+		{
+			saveNs = measure([&]
+							 { c.save(fileName); });
+			C loaded;
+			openNs = measure([&]
+							 { loaded.open(std::string(fileName) + ".txt"); });
+			report(name, type, "save", size, size, saveNs);
+			report(name, type, "open", size, size, openNs);
+			saveNs = measure([&]
+							 { c.save_binary(fileName); });
+			C snapshot;
+			openNs = measure([&]
+							 { snapshot.open_binary(fileName); });
+			report(name, type, "save_binary", size, size, saveNs);
+			report(name, type, "open_binary", size, size, openNs);
+		}
+		else
+		{
+			saveNs = measure([&]
+							 {
+								 std::ofstream file(std::string(fileName) + ".txt");
+								 for (auto &x : c)
+									 file << x << '\n'; });
+			C loaded;
+			openNs = measure([&]
+							 {
+								 std::ifstream file(std::string(fileName) + ".txt");
+								 std::string line;
+								 T elem;
+								 while (std::getline(file, line))
+								 {
+									 std::istringstream ss(line);
+									 ss >> elem;
+									 loaded.push_back(elem);
+								 } });
+			report(name, type, "save", size, size, saveNs);
+			report(name, type, "open", size, size, openNs);
+		}
+		std::remove(fileName);
+		std::remove((std::string(fileName) + ".txt").c_str());
+	}
+	{
+		C copy(c);
+		report(name, type, "pop_back", size, size, measure([&]
+															 { for (size_t i = 0; i < size; i++) copy.pop_back(); }));
+	}
+	if (!vector || size <= linearLimit)
+	{
+		C copy(c);
+		double ns;
+		if constexpr (ours)
+			ns = measure([&]
+						 { for (size_t i = 0; i < size; i++) copy.pop_front(); });
+		else
+			ns = measure([&]
+						 { for (size_t i = 0; i < size; i++) popFront(copy); });
+		report(name, type, "pop_front", size, size, ns);
+
+		C front;
+		if constexpr (ours)
+			ns = measure([&]
+						 { for (size_t i = 0; i < size; i++) front.push_front(values[i]); });
+		else
+			ns = measure([&]
+						 { for (size_t i = 0; i < size; i++) pushFront(front, values[i]); });
+		report(name, type, "push_front", size, size, ns);
+	}
+	report(name, type, "clear", size, size, measure([&]
+													  { c.clear(); }));
+}
+
+/** Checks if a filter accepts a name
+ * @param filter - value given on the command line
+ * @param name - name to check
+ * @return true if the name should be benchmarked
+ */
+bool accepted(const std::string &filter, const char *name)
+{
+	return filter == "all" || filter == name;
+}
+
+/** Runs all containers for one element type*/
+template <class T>
+void runType(size_t maxSize, const std::string &containerFilter, const std::string &typeFilter)
+{
+	if (!accepted(typeFilter, typeName<T>()))
+		return;
+	std::mt19937 rng(2023);
+	for (size_t size = 100; size <= maxSize; size *= 10)
+	{
+		std::vector<T> values;
+		values.reserve(size);
+		for (size_t i = 0; i < size; i++)
+			values.push_back(makeValue<T>(i, rng));
+		if (accepted(containerFilter, "list"))
+			runCase<list<T>>("list", size, values);
+		if (accepted(containerFilter, "std::list"))
+			runCase<std::list<T>>("std::list", size, values);
+		if (accepted(containerFilter, "std::deque"))
+			runCase<std::deque<T>>("std::deque", size, values);
+		if (accepted(containerFilter, "std::vector"))
+			runCase<std::vector<T>>("std::vector", size, values);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	size_t maxSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	std::string containerFilter = argc > 2 ? argv[2] : "all";
+	std::string typeFilter = argc > 3 ? argv[3] : "all";
+
+	std::printf("container,type,operation,size,ops,ns_per_op,ops_per_sec,peak_rss_kb\n");
+	runType<int>(maxSize, containerFilter, typeFilter);
+	runType<std::string>(maxSize, containerFilter, typeFilter);
+	runType<person>(maxSize, containerFilter, typeFilter);
+	return 0;
+}
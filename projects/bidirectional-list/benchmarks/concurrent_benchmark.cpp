@@ -0,0 +1,132 @@
+/**
+ * @file concurrent_benchmark.cpp
+ * @brief Multi-threaded throughput of concurrent_list<T> compared with list<T> guarded by one mutex,
+ * for 1 to 32 threads.
+ *
+ * Workloads:
+ *     queue - every thread pushes at the back and pops from the front
+ *     deque - every thread pushes and pops at randomly chosen ends
+ * Results are printed as CSV:
+ *     container,workload,threads,ops,ms,ops_per_sec
+ *
+ * Build (from projects/bidirectional-list):
+ *     g++ -std=c++17 -O2 -I. -pthread benchmarks/concurrent_benchmark.cpp functions.cpp -o concurrent_benchmark
+ * Usage:
+ *     concurrent_benchmark [operations per thread] [max threads]
+ *
+ */
+
+#include "functions.h"
+#include "concurrent_list.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** list<T> with every operation under one mutex, the reference the lock-free list is compared with*/
+template <class T>
+class lockedList
+{
+	list<T> l;		  /**< Guarded list*/
+	std::mutex lock; /**< Mutex taken by every operation*/
+
+public:
+	void push_back(const T &elem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		l.push_back(elem);
+	}
+	void push_front(const T &elem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		l.push_front(elem);
+	}
+	bool try_pop_back(T &elem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (l.empty())
+			return false;
+		elem = l.pop_back();
+		return true;
+	}
+	bool try_pop_front(T &elem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (l.empty())
+			return false;
+		elem = l.pop_front();
+		return true;
+	}
+};
+
+/** Runs one workload on given number of threads
+ * @param container - list to use
+ * @param threadCount - number of threads
+ * @param operations - number of push and pop pairs done by each thread
+ * @param randomEnds - false for the queue workload, true for the deque workload
+ * @return Time in milliseconds
+ */
+template <class C>
+double run(C &container, unsigned threadCount, size_t operations, bool randomEnds)
+{
+	std::vector<std::thread> threads;
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threadCount; t++)
+		threads.emplace_back([&container, operations, randomEnds, t]
+							 {
+								 uint32_t seed = 2463534242u + t;
+								 int elem = 0;
+								 for (size_t i = 0; i < operations; i++)
+								 {
+									 seed ^= seed << 13;
+									 seed ^= seed >> 17;
+									 seed ^= seed << 5;
+									 if (randomEnds && (seed & 1))
+										 container.push_front(static_cast<int>(i));
+									 else
+										 container.push_back(static_cast<int>(i));
+									 if (randomEnds && (seed & 2))
+										 container.try_pop_back(elem);
+									 else
+										 container.try_pop_front(elem);
+								 } });
+	for (auto &t : threads)
+		t.join();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+/** Prints one CSV line*/
+void report(const char *container, const char *workload, unsigned threads, size_t ops, double ms)
+{
+	std::printf("%s,%s,%u,%zu,%.2f,%.0f\n", container, workload, threads, ops, ms, ms == 0 ? 0 : ops * 1000.0 / ms);
+	std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+	size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 32;
+
+	std::printf("container,workload,threads,ops,ms,ops_per_sec\n");
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		for (bool randomEnds : {false, true})
+		{
+			const char *workload = randomEnds ? "deque" : "queue";
+			size_t ops = 2 * operations * threads;
+			{
+				concurrent_list<int> l;
+				report("concurrent_list", workload, threads, ops, run(l, threads, operations, randomEnds));
+			}
+			{
+				lockedList<int> l;
+				report("mutex_list", workload, threads, ops, run(l, threads, operations, randomEnds));
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file sort_benchmark.cpp
+ * @brief Compares list<T>::sort() (merge sort), list<T>::parallel_sort() and list<T>::sort_by() with integral
+ * keys (radix sort; people are sorted by age with ties broken by operator<) with the previous bubble sort
+ * on lists of 10^3 to 10^7 elements.
+ *
+ * Build (from projects/bidirectional-list):
+ *     g++ -std=c++17 -O2 -I. -pthread benchmarks/sort_benchmark.cpp functions.cpp -o sort_benchmark
+ * Usage:
+ *     sort_benchmark [max size] [max size for bubble sort]
+ *
+ */
+
+#include "functions.h"
+
+#include <chrono>
+#include <random>
+#include <utility>
+#include <cstdlib>
+
+/** Bubble sort with the same passes as the old list<T>::sort(), used as a reference
+ * @param l - list to sort
+ */
+template <class T>
+void bubbleSort(list<T> &l)
+{
+	for (size_t i = 1; i < l.getSize(); i++)
+	{
+		auto first = l.begin();
+		auto second = first;
+		++second;
+		while (second != l.end())
+		{
+			if (*second < *first)
+				std::swap(*first, *second);
+			first = second;
+			++second;
+		}
+	}
+}
+
+/** Fills list with random people, names are taken from a small set like in pepl.txt
+ * @param l - list to fill
+ * @param count - number of people to add
+ * @param rng - random number generator
+ */
+void fillPeople(list<person> &l, size_t count, std::mt19937 &rng)
+{
+	static const std::string names[] = {"Jan", "Kamil", "Maciej", "Adam", "Anna", "Ewa", "Piotr", "Zofia"};
+	std::uniform_int_distribution<int> age(0, 99);
+	std::uniform_int_distribution<int> name(0, 7);
+	for (size_t i = 0; i < count; i++)
+		l.push_back(person(names[name(rng)], age(rng)));
+}
+
+/** Measures time of a callable
+ * @param f - callable to measure
+ * @return Time in milliseconds
+ */
+template <class F>
+double measure(F f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+	size_t maxSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	size_t maxBubbleSize = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+	std::mt19937 rng(2023);
+
+	std::cout << "type,size,merge_sort_ms,parallel_sort_ms,radix_sort_ms,bubble_sort_ms\n";
+	for (size_t size = 1000; size <= maxSize; size *= 10)
+	{
+		list<int> ints;
+		std::uniform_int_distribution<int> value;
+		for (size_t i = 0; i < size; i++)
+			ints.push_back(value(rng));
+		list<int> intsCopy(ints);
+		list<int> intsParallel(ints);
+		list<int> intsRadix(ints);
+		double merge = measure([&]
+							   { ints.sort(); });
+		double parallel = measure([&]
+								  { intsParallel.parallel_sort(); });
+		double radix = measure([&]
+							   { intsRadix.sort_by(identityKey()); });
+		std::cout << "int," << size << "," << merge << "," << parallel << "," << radix << ",";
+		if (size <= maxBubbleSize)
+			std::cout << measure([&]
+								 { bubbleSort(intsCopy); });
+		else
+			std::cout << "skipped";
+		std::cout << "\n";
+
+		list<person> people;
+		fillPeople(people, size, rng);
+		list<person> peopleCopy(people);
+		list<person> peopleParallel(people);
+		list<person> peopleRadix(people);
+		merge = measure([&]
+						{ people.sort(); });
+		parallel = measure([&]
+						   { peopleParallel.parallel_sort(); });
+		radix = measure([&]
+						{ peopleRadix.sort_by(&person::getAge, [](person &a, person &b)
+											  { return a < b; }); });
+		std::cout << "person," << size << "," << merge << "," << parallel << "," << radix << ",";
+		if (size <= maxBubbleSize)
+			std::cout << measure([&]
+								 { bubbleSort(peopleCopy); });
+		else
+			std::cout << "skipped";
+		std::cout << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,619 @@
+/**
+ * @file compact_list.h
+ * @brief Bidirectional list kept in one growable array, nodes are linked by 32-bit indices
+ *
+ */
+
+#pragma once
+
+#ifndef COMPACT_LIST_H
+#define COMPACT_LIST_H
+
+#include "functions.h"
+
+#include <algorithm>
+#include <cstdint>
+
+template <class T, bool XorLinks>
+/**Struct used to store data, node of 'compact_list' class with separate links to both neighbours*/
+struct compactListNode
+{
+	alignas(T) unsigned char storage[sizeof(T)]; /**< Memory for the data, the element exists only while the slot is used*/
+	uint32_t previousNode;						  /**< Index of the previous node, 0 if there is none*/
+	uint32_t nextNode;							  /**< Index of the next node (or of the next free slot), 0 if there is none*/
+
+	/** Returns element stored in the node
+	 * @return Pointer to the element
+	 */
+	T *data() { return std::launder(reinterpret_cast<T *>(storage)); }
+};
+
+template <class T>
+/**Struct used to store data, node of 'compact_list' class with one XOR-ed link (index of previous ^ index of next)*/
+struct compactListNode<T, true>
+{
+	alignas(T) unsigned char storage[sizeof(T)]; /**< Memory for the data, the element exists only while the slot is used*/
+	uint32_t links;								  /**< Index of the previous node XOR index of the next one (or index of the next free slot)*/
+
+	/** Returns element stored in the node
+	 * @return Pointer to the element
+	 */
+	T *data() { return std::launder(reinterpret_cast<T *>(storage)); }
+};
+
+template <class T, bool XorLinks = false>
+/**Bidirectional list with nodes stored in one array instead of separate allocations.
+ *
+ * Nodes refer to each other with 32-bit indices into the array (index 0 means no node), so a node of list<int>
+ * takes 12 bytes instead of 24 (8 bytes with XorLinks, where a node keeps only previous ^ next and the list
+ * is walked with two indices at a time). Removed slots are kept on a free list and reused before the array grows.
+ * Growing moves the elements to a twice as big array, but keeps their indices, so iterators stay valid.
+ * An iterator also remembers the node before its element; with XorLinks it is needed to walk on, so inserting
+ * or removing an element right before an iterator invalidates it (without XorLinks only erasing its own element does).
+ * At most 2^32 - 2 elements can be stored.
+ */
+class compact_list
+{
+private:
+	using node = compactListNode<T, XorLinks>;
+
+	node *nodes = nullptr;	  /**< Array of slots, slot 0 is never used*/
+	uint32_t capacity = 0;	  /**< Number of slots in the array*/
+	uint32_t highWater = 1;	  /**< First slot which has never been used*/
+	uint32_t freeSlot = 0;	  /**< First slot of the free list, 0 if the list is empty*/
+	uint32_t head = 0;		  /**< Index of the first node*/
+	uint32_t tail = 0;		  /**< Index of the last node*/
+	size_t size = 0;		  /**< Size of the list*/
+
+	static constexpr uint32_t firstCapacity = 16; /**< Number of slots allocated for the first element*/
+
+	/** Returns index of the node after 'current'
+	 * @param previous - index of the node before 'current' (needed only with XorLinks)
+	 * @param current - index of the node
+	 */
+	uint32_t nextOf(uint32_t previous, uint32_t current) const
+	{
+		if constexpr (XorLinks)
+			return nodes[current].links ^ previous;
+		else
+			return nodes[current].nextNode;
+	}
+	/** Returns index of the node before 'current'
+	 * @param current - index of the node
+	 * @param next - index of the node after 'current' (needed only with XorLinks)
+	 */
+	uint32_t previousOf(uint32_t current, uint32_t next) const
+	{
+		if constexpr (XorLinks)
+			return nodes[current].links ^ next;
+		else
+			return nodes[current].previousNode;
+	}
+	/** Sets both links of a node
+	 * @param n - index of the node
+	 * @param previous - index of the node before it
+	 * @param next - index of the node after it
+	 */
+	void setLinks(uint32_t n, uint32_t previous, uint32_t next)
+	{
+		if constexpr (XorLinks)
+			nodes[n].links = previous ^ next;
+		else
+		{
+			nodes[n].previousNode = previous;
+			nodes[n].nextNode = next;
+		}
+	}
+	/** Replaces the previous neighbour of a node
+	 * @param n - index of the node, 0 means the head of the list
+	 * @param oldPrevious - current previous neighbour
+	 * @param newPrevious - new previous neighbour
+	 */
+	void replacePrevious(uint32_t n, uint32_t oldPrevious, uint32_t newPrevious)
+	{
+		if (n == 0)
+			tail = newPrevious;
+		else if constexpr (XorLinks)
+			nodes[n].links ^= oldPrevious ^ newPrevious;
+		else
+			nodes[n].previousNode = newPrevious;
+	}
+	/** Replaces the next neighbour of a node
+	 * @param n - index of the node, 0 means the tail of the list
+	 * @param oldNext - current next neighbour
+	 * @param newNext - new next neighbour
+	 */
+	void replaceNext(uint32_t n, uint32_t oldNext, uint32_t newNext)
+	{
+		if (n == 0)
+			head = newNext;
+		else if constexpr (XorLinks)
+			nodes[n].links ^= oldNext ^ newNext;
+		else
+			nodes[n].nextNode = newNext;
+	}
+	/** Link used by the free list, stored in place of the links of an unused slot*/
+	uint32_t &freeLink(uint32_t n)
+	{
+		if constexpr (XorLinks)
+			return nodes[n].links;
+		else
+			return nodes[n].nextNode;
+	}
+	/** Moves all slots to an array of given size, indices of the nodes do not change
+	 * @param newCapacity - number of slots of the new array
+	 */
+	void reallocate(uint32_t newCapacity)
+	{
+		node *newNodes = new node[newCapacity];
+		for (uint32_t previous = 0, current = head; current != 0;)
+		{
+			uint32_t next = nextOf(previous, current);
+			new (newNodes[current].storage) T(std::move(*nodes[current].data()));
+			nodes[current].data()->~T();
+			previous = current;
+			current = next;
+		}
+		for (uint32_t i = 1; i < highWater; i++)
+		{
+			if constexpr (XorLinks)
+				newNodes[i].links = nodes[i].links;
+			else
+			{
+				newNodes[i].previousNode = nodes[i].previousNode;
+				newNodes[i].nextNode = nodes[i].nextNode;
+			}
+		}
+		delete[] nodes;
+		nodes = newNodes;
+		capacity = newCapacity;
+	}
+	/** Takes a slot from the free list or from the unused part of the array, grows the array if it is full
+	 * @return Index of the slot
+	 */
+	uint32_t allocateSlot()
+	{
+		if (freeSlot != 0)
+		{
+			uint32_t n = freeSlot;
+			freeSlot = freeLink(n);
+			return n;
+		}
+		if (highWater >= capacity)
+		{
+			if (capacity == UINT32_MAX)
+				throw std::bad_alloc();
+			reallocate(capacity == 0 ? firstCapacity : capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2);
+		}
+		return highWater++;
+	}
+	/** Puts slot on the free list
+	 * @param n - index of the slot, its element has to be destroyed already
+	 */
+	void releaseSlot(uint32_t n)
+	{
+		freeLink(n) = freeSlot;
+		freeSlot = n;
+	}
+	/** Creates node and links it in between two neighbouring nodes
+	 * @param previous - index of the node before the new one, 0 to insert at the beginning
+	 * @param next - index of the node after the new one, 0 to insert at the end
+	 * @param elem - element to store
+	 * @return Index of the new node
+	 */
+	uint32_t linkNode(uint32_t previous, uint32_t next, T &&elem)
+	{
+		uint32_t n = allocateSlot();
+		try
+		{
+			new (nodes[n].storage) T(std::move(elem));
+		}
+		catch (...)
+		{
+			releaseSlot(n);
+			throw;
+		}
+		setLinks(n, previous, next);
+		replaceNext(previous, next, n);
+		replacePrevious(next, previous, n);
+		size++;
+		return n;
+	}
+	/** Unlinks node and frees its slot
+	 * @param previous - index of the node before it
+	 * @param n - index of the node
+	 * @param next - index of the node after it
+	 * @return Removed element
+	 */
+	T unlinkNode(uint32_t previous, uint32_t n, uint32_t next)
+	{
+		T val = std::move(*nodes[n].data());
+		nodes[n].data()->~T();
+		replaceNext(previous, n, next);
+		replacePrevious(next, n, previous);
+		releaseSlot(n);
+		size--;
+		return val;
+	}
+
+public:
+	/** Bidirectional iterator class, remembers the node and the one before it (needed to walk XOR links)*/
+	class iterator
+	{
+		friend class compact_list<T, XorLinks>;
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T *;
+		using reference = T &;
+
+		/** Constructor for an iterator object
+		 * @param _owner - list the iterator belongs to
+		 * @param _previous - index of the node before the element
+		 * @param _current - index of the node of the element, 0 for end()
+		 */
+		iterator(compact_list *_owner, uint32_t _previous, uint32_t _current) : owner(_owner), previous(_previous), current(_current) {}
+		/** Dereference operator
+		 * @return Returns reference to the element
+		 */
+		T &operator*() const { return *owner->nodes[current].data(); }
+		/** Gives access to members of the element*/
+		T *operator->() const { return owner->nodes[current].data(); }
+		/** Increment operator - iterator is moved to the next element in the list
+		 * @return reference to the iterator
+		 */
+		iterator &operator++()
+		{
+			uint32_t next = owner->nextOf(previous, current);
+			previous = current;
+			current = next;
+			return *this;
+		}
+		/** Decrement operator - iterator is moved to the previous element in the list, end() can be decremented
+		 * @return reference to the iterator
+		 */
+		iterator &operator--()
+		{
+			uint32_t next = current;
+			current = owner->previousOf(*this);
+			previous = current == 0 ? 0 : owner->previousOf(current, next);
+			return *this;
+		}
+		/** Equality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the same element, false otherwise
+		 */
+		bool operator==(const iterator &other) const { return current == other.current && (!XorLinks || current != 0 || previous == other.previous); }
+		/** Inequality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to different elements, false otherwise
+		 */
+		bool operator!=(const iterator &other) const { return !(*this == other); }
+
+	private:
+		compact_list *owner; /**< List the iterator belongs to*/
+		uint32_t previous;	 /**< Index of the node before the element*/
+		uint32_t current;	 /**< Index of the node of the element, 0 for end()*/
+	};
+
+private:
+	/** Returns index of the node before the element of an iterator. Without XorLinks it is read from the node,
+	 * so the iterator may be older than changes next to it; with XorLinks the index kept by the iterator is used.
+	 * @param position - iterator pointing to an element or end()
+	 */
+	uint32_t previousOf(const iterator &position) const
+	{
+		if (position.current == 0)
+			return tail;
+		if constexpr (XorLinks)
+			return position.previous;
+		else
+			return nodes[position.current].previousNode;
+	}
+
+public:
+	/** Default list constructor, creates blank list*/
+	compact_list() = default;
+	/** Copy constructor, creates a copy of the other list*/
+	compact_list(const compact_list &otherList)
+	{
+		reserve(otherList.size);
+		for (uint32_t previous = 0, current = otherList.head; current != 0;)
+		{
+			push_back(*otherList.nodes[current].data());
+			uint32_t next = otherList.nextOf(previous, current);
+			previous = current;
+			current = next;
+		}
+	}
+	/** Move constructor*/
+	compact_list(compact_list &&otherList) noexcept
+		: nodes(otherList.nodes), capacity(otherList.capacity), highWater(otherList.highWater), freeSlot(otherList.freeSlot),
+		  head(otherList.head), tail(otherList.tail), size(otherList.size)
+	{
+		otherList.nodes = nullptr;
+		otherList.capacity = 0;
+		otherList.highWater = 1;
+		otherList.freeSlot = 0;
+		otherList.head = 0;
+		otherList.tail = 0;
+		otherList.size = 0;
+	}
+	/** Default list destructor*/
+	~compact_list()
+	{
+		clear();
+		delete[] nodes;
+	}
+	/** Copy assignment operator
+	 * @param otherList - the list to copy the contents from
+	 * @return A reference to the current list with the copied contents
+	 */
+	compact_list &operator=(const compact_list &otherList)
+	{
+		if (this != &otherList)
+		{
+			compact_list copy(otherList);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+	/** Move assignment operator
+	 * @param otherList - the list to move the contents from
+	 * @return A reference to the current list with the moved contents
+	 */
+	compact_list &operator=(compact_list &&otherList) noexcept
+	{
+		if (this != &otherList)
+		{
+			clear();
+			delete[] nodes;
+			nodes = otherList.nodes;
+			capacity = otherList.capacity;
+			highWater = otherList.highWater;
+			freeSlot = otherList.freeSlot;
+			head = otherList.head;
+			tail = otherList.tail;
+			size = otherList.size;
+			otherList.nodes = nullptr;
+			otherList.capacity = 0;
+			otherList.highWater = 1;
+			otherList.freeSlot = 0;
+			otherList.head = 0;
+			otherList.tail = 0;
+			otherList.size = 0;
+		}
+		return *this;
+	}
+
+	/** Method which allows to add element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(T elem) { linkNode(tail, 0, std::move(elem)); }
+	/** Method which allows to add element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(T elem) { linkNode(0, head, std::move(elem)); }
+	/** Inserts element before given position. With XorLinks 'position' is invalidated, use the returned iterator.
+	 * @param position - iterator to the element before which the new one is inserted, may be end()
+	 * @param elem - element to insert
+	 * @return Iterator to the inserted element
+	 */
+	iterator insert(iterator position, T elem)
+	{
+		uint32_t previous = previousOf(position);
+		uint32_t n = linkNode(previous, position.current, std::move(elem));
+		return iterator(this, previous, n);
+	}
+	/** Removes element at given position. With XorLinks an iterator to the next element is invalidated, use the returned one.
+	 * @param position - iterator to the element to remove
+	 * @return Iterator to the element after the removed one
+	 */
+	iterator erase(iterator position)
+	{
+		if (position.current == 0)
+			throw myException(errorType::outOfRange);
+		uint32_t previous = previousOf(position);
+		uint32_t next = nextOf(previous, position.current);
+		unlinkNode(previous, position.current, next);
+		return iterator(this, previous, next);
+	}
+	/** Returns the last element
+	 * @return Reference to the last element
+	 */
+	T &back()
+	{
+		if (tail == 0)
+			throw myException(errorType::emptyList);
+		return *nodes[tail].data();
+	}
+	/** Returns the first element
+	 * @return Reference to the first element
+	 */
+	T &front()
+	{
+		if (head == 0)
+			throw myException(errorType::emptyList);
+		return *nodes[head].data();
+	}
+	/** Method which checks if the list is empty
+	 * @return true if the list is empty, false otherwise
+	 */
+	bool empty() const { return head == 0; }
+	/** Returns the number of elements in the list
+	 * @return The number of elements in the list
+	 */
+	size_t getSize() const { return size; }
+	/** Returns the number of slots in the array
+	 * @return Number of elements the list can hold without growing
+	 */
+	size_t getCapacity() const { return capacity == 0 ? 0 : capacity - 1; }
+	/** Makes sure that given number of elements fits without growing the array
+	 * @param count - number of elements
+	 */
+	void reserve(size_t count)
+	{
+		if (count >= UINT32_MAX)
+			throw std::bad_alloc();
+		if (count + 1 > capacity)
+			reallocate(static_cast<uint32_t>(count + 1));
+	}
+	/** Method which allows to pop last element from the list
+	 * @return Deleted element
+	 */
+	T pop_back()
+	{
+		if (tail == 0)
+			throw myException(errorType::emptyList);
+		return unlinkNode(previousOf(tail, 0), tail, 0);
+	}
+	/** Method which allows to pop first element from the list
+	 * @return Deleted element
+	 */
+	T pop_front()
+	{
+		if (head == 0)
+			throw myException(errorType::emptyList);
+		return unlinkNode(0, head, nextOf(0, head));
+	}
+	/** Method which allows to pop element in a chosen position in the list, the list is walked from the closer end
+	 * @param position - position of the element to pop
+	 * @return Deleted element
+	 */
+	T pop_specified_position(int position)
+	{
+		if (position < 0 || static_cast<size_t>(position) >= size)
+			throw myException(errorType::outOfRange);
+		iterator it = begin();
+		if (static_cast<size_t>(position) < size / 2)
+		{
+			for (int i = 0; i < position; i++)
+				++it;
+		}
+		else
+		{
+			it = end();
+			for (size_t i = size - static_cast<size_t>(position); i > 0; i--)
+				--it;
+		}
+		uint32_t next = nextOf(it.previous, it.current);
+		return unlinkNode(it.previous, it.current, next);
+	}
+	/** Method displays all elements of the list*/
+	void display()
+	{
+		if (head == 0)
+		{
+			std::cout << "\t/Empty list!/" << std::endl;
+			return;
+		}
+		for (T &elem : *this)
+			std::cout << elem << '\n';
+		std::cout << std::flush;
+	}
+	/** Search for an element in the list
+	 * @param elem - the elements to search for
+	 */
+	void search(T elem)
+	{
+		int elemCounter = 0;
+		bool elemFound = false;
+		for (T &data : *this)
+		{
+			if (elem == data)
+			{
+				std::cout << data << " at [" << elemCounter << "] position." << std::endl;
+				elemFound = true;
+			}
+			++elemCounter;
+		}
+		if (!elemFound)
+			std::cout << elem << " not found." << std::endl;
+	}
+	/** Sorts the elements in the list using operator< (stable)*/
+	void sort()
+	{
+		sort([](const T &a, const T &b)
+			 { return a < b; });
+	}
+	/** Sorts the elements in the list using given comparator. Indices of the nodes are sorted
+	 * and the nodes are relinked in the new order, elements are not moved. Sort is stable.
+	 * @param comp - callable returning true if the first argument should go before the second one
+	 */
+	template <class Compare>
+	void sort(Compare comp)
+	{
+		std::vector<uint32_t> order;
+		order.reserve(size);
+		for (iterator it = begin(); it != end(); ++it)
+			order.push_back(it.current);
+		std::stable_sort(order.begin(), order.end(), [this, &comp](uint32_t a, uint32_t b)
+						 { return comp(*nodes[a].data(), *nodes[b].data()); });
+		for (size_t i = 0; i < order.size(); i++)
+			setLinks(order[i], i == 0 ? 0 : order[i - 1], i + 1 == order.size() ? 0 : order[i + 1]);
+		if (!order.empty())
+		{
+			head = order.front();
+			tail = order.back();
+		}
+	}
+	/** Saves the contents of the list to a specified file
+	 * @param fileName The name of the file to save the list to
+	 */
+	void save(std::string fileName)
+	{
+		fileName += ".txt";
+		std::ofstream fileToSave(fileName);
+		if (!fileToSave)
+			throw myException();
+		for (T &elem : *this)
+			fileToSave << elem << '\n';
+	}
+	/** Opens a list from a specified file, lines which cannot be parsed by listParser<T> are skipped
+	 * @param fileName The name of the file to open the list from
+	 */
+	void open(std::string fileName)
+	{
+		if (head != 0)
+			throw myException(errorType::nonEmptyList);
+		mappedFile file(fileName);
+		file.forEachLine([this](std::string_view line)
+						 {
+			T elem;
+			if (listParser<T>::parse(line, elem))
+				push_back(elem); });
+	}
+	/** Removes all elements, the array is kept for reuse*/
+	void clear()
+	{
+		for (uint32_t previous = 0, current = head; current != 0;)
+		{
+			uint32_t next = nextOf(previous, current);
+			nodes[current].data()->~T();
+			previous = current;
+			current = next;
+		}
+		head = 0;
+		tail = 0;
+		size = 0;
+		freeSlot = 0;
+		highWater = 1;
+	}
+
+	/** Returns an iterator pointing to the first element of the list
+	 * @return Iterator pointing to the first element of the list
+	 */
+	iterator begin() { return iterator(this, 0, head); }
+	/** Returns an iterator pointing to the end of the list
+	 * @return Iterator pointing to the end of the list
+	 */
+	iterator end() { return iterator(this, tail, 0); }
+};
+
+/** Compact list with XOR-ed links, a node of xor_list<int> takes 8 bytes*/
+template <class T>
+using xor_list = compact_list<T, true>;
+
+#endif /* COMPACT_LIST_H */
@@ -0,0 +1,604 @@
+/**
+ * @file concurrent_list.h
+ * @brief Lock-free bidirectional list for many producers and consumers working at both ends
+ *
+ */
+
+#pragma once
+
+#ifndef CONCURRENT_LIST_H
+#define CONCURRENT_LIST_H
+
+#include "functions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+template <class T>
+/**Struct used to store data, node of 'concurrent_list' class. Links are indices of nodes instead of pointers
+ * (0 means no node), so that indices of both ends of the list fit in one word which can be swapped atomically.
+ */
+struct concurrentListNode
+{
+	alignas(T) unsigned char storage[sizeof(T)]; /**< Memory for the data, the element exists only while the node is in the list*/
+	std::atomic<uint32_t> previousNode{0};		  /**< Index of the previous node*/
+	std::atomic<uint32_t> nextNode{0};			  /**< Index of the next node*/
+	std::atomic<uint32_t> nextFree{0};			  /**< Index of the next unused node, valid only while the node is on the free list*/
+
+	/** Returns element stored in the node
+	 * @return Pointer to the element
+	 */
+	T *data() { return std::launder(reinterpret_cast<T *>(storage)); }
+};
+
+template <class T>
+/**Bidirectional list which can be used from many threads at once, e.g. as a work queue.
+ *
+ * push_back(), push_front(), pop_back() and pop_front() are lock-free (CAS-based deque by M. M. Michael):
+ * both ends and a status are kept in one atomic word. A push swaps the end first and marks the list unstable,
+ * then links the old end to the new node. Any thread which finds the list unstable finishes that link itself,
+ * so no thread has to wait for another one.
+ *
+ * Nodes live in segments (64, 128, 256... nodes) which are never freed before the list, free nodes are kept on
+ * a lock-free stack. A removed node is reused only when no thread has its index published as a hazard pointer,
+ * this makes reading links of a node removed in the meantime safe and prevents ABA on the ends word.
+ * Only allocation of a new segment takes a mutex.
+ *
+ * The list can not be iterated, copied or moved, getSize() is exact only when no other thread modifies the list.
+ */
+class concurrent_list
+{
+private:
+	using node = concurrentListNode<T>;
+
+	/** Status of the list kept next to its ends*/
+	enum listStatus : uint64_t
+	{
+		stable = 0,		 /**< All links between nodes are set*/
+		pushedBack = 1, /**< Last node was pushed, but the node before it does not point to it yet*/
+		pushedFront = 2 /**< First node was pushed, but the node after it does not point to it yet*/
+	};
+
+	/** Hazard pointers of one thread. Nodes which indices are published here are not reused*/
+	struct hazardRecord
+	{
+		std::atomic<uint32_t> hazards[3];  /**< Protected nodes: first one, last one and neighbour of a pushed node*/
+		std::atomic<bool> active{false};   /**< True while a thread uses the record*/
+		std::vector<uint32_t> retired;	   /**< Removed nodes waiting until no thread protects them*/
+		hazardRecord *nextRecord = nullptr; /**< Next record of the list*/
+
+		hazardRecord()
+		{
+			for (auto &h : hazards)
+				h.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	/** Takes hazard record for the time of one operation*/
+	struct recordGuard
+	{
+		concurrent_list &owner; /**< List the record belongs to*/
+		hazardRecord *record;	/**< Record used by the operation*/
+
+		recordGuard(concurrent_list &l) : owner(l), record(l.acquireRecord()) {}
+		~recordGuard() { owner.releaseRecord(record); }
+	};
+
+	static constexpr unsigned firstSegmentShift = 6;			/**< First segment holds 2^6 nodes, every next one twice as many*/
+	static constexpr unsigned maxSegments = 31 - firstSegmentShift; /**< Enough segments for indices up to 2^31*/
+	static constexpr size_t retireThreshold = 64;				/**< Number of removed nodes which triggers a hazard pointer scan*/
+
+	std::atomic<uint64_t> ends{0};				/**< Index of the first node (bits 0-30), of the last node (bits 31-61) and status (bits 62-63)*/
+	std::atomic<uint64_t> freeHead{0};			/**< Index of the first free node (low half) and a counter of changes (high half)*/
+	std::atomic<size_t> size{0};				/**< Number of elements*/
+	std::atomic<hazardRecord *> records{nullptr}; /**< Hazard records of all threads which used the list*/
+	std::atomic<node *> segments[maxSegments];	/**< Arrays of nodes*/
+	unsigned segmentCount = 0;					/**< Number of allocated segments, guarded by 'growLock'*/
+	std::mutex growLock;						/**< Mutex taken while a new segment is allocated*/
+
+	/** Packs both ends and status into one word*/
+	static uint64_t makeEnds(uint32_t first, uint32_t last, uint64_t status) { return uint64_t(first) | uint64_t(last) << 31 | status << 62; }
+	/** Returns index of the first node from packed ends*/
+	static uint32_t firstOf(uint64_t e) { return uint32_t(e & 0x7fffffffu); }
+	/** Returns index of the last node from packed ends*/
+	static uint32_t lastOf(uint64_t e) { return uint32_t(e >> 31 & 0x7fffffffu); }
+	/** Returns status from packed ends*/
+	static uint64_t statusOf(uint64_t e) { return e >> 62; }
+
+	/** Returns position of the highest set bit
+	 * @param v - non zero value
+	 */
+	static unsigned highestBit(uint32_t v)
+	{
+#if defined(_MSC_VER)
+		unsigned long bit;
+		_BitScanReverse(&bit, v);
+		return static_cast<unsigned>(bit);
+#else
+		return 31u - static_cast<unsigned>(__builtin_clz(v));
+#endif
+	}
+	/** Finds node by its index
+	 * @param index - index of the node, greater than 0
+	 * @return Pointer to the node
+	 */
+	node *nodeAt(uint32_t index)
+	{
+		uint32_t slot = index + (1u << firstSegmentShift) - 1;
+		unsigned bit = highestBit(slot);
+		return segments[bit - firstSegmentShift].load(std::memory_order_acquire) + (slot - (1u << bit));
+	}
+
+	/** Allocates the next segment and puts all its nodes on the free list*/
+	void grow()
+	{
+		std::lock_guard<std::mutex> lock(growLock);
+		if (uint32_t(freeHead.load()) != 0)
+			return;
+		if (segmentCount == maxSegments)
+			throw std::bad_alloc();
+		uint32_t capacity = 1u << (firstSegmentShift + segmentCount);
+		uint32_t first = capacity - (1u << firstSegmentShift) + 1;
+		node *segment = new node[capacity];
+		for (uint32_t i = 0; i + 1 < capacity; i++)
+			segment[i].nextFree.store(first + i + 1, std::memory_order_relaxed);
+		segments[segmentCount].store(segment, std::memory_order_release);
+		++segmentCount;
+		pushFree(first, first + capacity - 1);
+	}
+	/** Puts chain of nodes linked by 'nextFree' on the free list
+	 * @param first - index of the first node of the chain
+	 * @param last - index of the last node of the chain
+	 */
+	void pushFree(uint32_t first, uint32_t last)
+	{
+		node *tail = nodeAt(last);
+		uint64_t head = freeHead.load();
+		do
+			tail->nextFree.store(uint32_t(head));
+		while (!freeHead.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | first));
+	}
+	/** Takes node from the free list, allocates a new segment if the list is empty
+	 * @return Index of the node
+	 */
+	uint32_t allocateNode()
+	{
+		uint64_t head = freeHead.load();
+		while (true)
+		{
+			uint32_t index = uint32_t(head);
+			if (index == 0)
+			{
+				grow();
+				head = freeHead.load();
+				continue;
+			}
+			uint32_t next = nodeAt(index)->nextFree.load();
+			if (freeHead.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | next))
+				return index;
+		}
+	}
+
+	/** Finds unused hazard record or adds a new one
+	 * @return Record owned by the calling thread until releaseRecord()
+	 */
+	hazardRecord *acquireRecord()
+	{
+		for (hazardRecord *r = records.load(); r != nullptr; r = r->nextRecord)
+			if (!r->active.load(std::memory_order_relaxed) && !r->active.exchange(true, std::memory_order_acquire))
+				return r;
+		hazardRecord *r = new hazardRecord;
+		r->active.store(true, std::memory_order_relaxed);
+		hazardRecord *top = records.load();
+		do
+			r->nextRecord = top;
+		while (!records.compare_exchange_weak(top, r));
+		return r;
+	}
+	/** Clears hazard pointers and gives record back
+	 * @param r - record taken by acquireRecord()
+	 */
+	void releaseRecord(hazardRecord *r)
+	{
+		for (auto &h : r->hazards)
+			h.store(0, std::memory_order_release);
+		r->active.store(false, std::memory_order_release);
+	}
+	/** Reads ends of the list and protects both end nodes
+	 * @param r - record of the calling thread
+	 * @return Packed ends, their nodes are not reused until the hazards are changed
+	 */
+	uint64_t protectEnds(hazardRecord *r)
+	{
+		uint64_t e = ends.load();
+		while (true)
+		{
+			r->hazards[0].store(firstOf(e));
+			r->hazards[1].store(lastOf(e));
+			uint64_t current = ends.load();
+			if (current == e)
+				return e;
+			e = current;
+		}
+	}
+	/** Hands removed node over for reuse, it goes to the free list once no thread protects it
+	 * @param r - record of the calling thread
+	 * @param index - index of the removed node, its element has to be destroyed already
+	 */
+	void retire(hazardRecord *r, uint32_t index)
+	{
+		r->retired.push_back(index);
+		if (r->retired.size() < retireThreshold)
+			return;
+		std::vector<uint32_t> protectedNodes;
+		for (hazardRecord *other = records.load(); other != nullptr; other = other->nextRecord)
+			for (auto &h : other->hazards)
+				if (uint32_t i = h.load())
+					protectedNodes.push_back(i);
+		std::sort(protectedNodes.begin(), protectedNodes.end());
+		size_t kept = 0;
+		for (uint32_t i : r->retired)
+		{
+			if (std::binary_search(protectedNodes.begin(), protectedNodes.end(), i))
+				r->retired[kept++] = i;
+			else
+				pushFree(i, i);
+		}
+		r->retired.resize(kept);
+	}
+
+	/** Links the node before the pushed last node to it and marks the list stable
+	 * @param r - record of the calling thread, the pushed node has to be protected
+	 * @param e - packed ends with 'pushedBack' status
+	 */
+	void stabilizeBack(hazardRecord *r, uint64_t e)
+	{
+		uint32_t last = lastOf(e);
+		uint32_t previous = nodeAt(last)->previousNode.load();
+		r->hazards[2].store(previous);
+		if (ends.load() != e)
+			return;
+		node *pointrr = nodeAt(previous);
+		uint32_t previousNext = pointrr->nextNode.load();
+		if (previousNext != last)
+		{
+			if (ends.load() != e)
+				return;
+			if (!pointrr->nextNode.compare_exchange_strong(previousNext, last))
+				return;
+		}
+		ends.compare_exchange_strong(e, makeEnds(firstOf(e), last, stable));
+	}
+	/** Links the node after the pushed first node to it and marks the list stable
+	 * @param r - record of the calling thread, the pushed node has to be protected
+	 * @param e - packed ends with 'pushedFront' status
+	 */
+	void stabilizeFront(hazardRecord *r, uint64_t e)
+	{
+		uint32_t first = firstOf(e);
+		uint32_t next = nodeAt(first)->nextNode.load();
+		r->hazards[2].store(next);
+		if (ends.load() != e)
+			return;
+		node *pointrr = nodeAt(next);
+		uint32_t nextPrevious = pointrr->previousNode.load();
+		if (nextPrevious != first)
+		{
+			if (ends.load() != e)
+				return;
+			if (!pointrr->previousNode.compare_exchange_strong(nextPrevious, first))
+				return;
+		}
+		ends.compare_exchange_strong(e, makeEnds(first, lastOf(e), stable));
+	}
+	/** Finishes push which left the list unstable
+	 * @param r - record of the calling thread, with both ends protected
+	 * @param e - packed ends
+	 */
+	void stabilize(hazardRecord *r, uint64_t e)
+	{
+		if (statusOf(e) == pushedBack)
+			stabilizeBack(r, e);
+		else
+			stabilizeFront(r, e);
+	}
+
+	/** Creates node holding a new element
+	 * @param args - arguments forwarded to the constructor of T
+	 * @return Index of the node
+	 */
+	template <class... Args>
+	uint32_t createNode(Args &&...args)
+	{
+		uint32_t index = allocateNode();
+		try
+		{
+			new (nodeAt(index)->storage) T(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			pushFree(index, index);
+			throw;
+		}
+		return index;
+	}
+	/** Links node in after the last one
+	 * @param index - index of the node
+	 */
+	void linkBack(uint32_t index)
+	{
+		node *n = nodeAt(index);
+		// Counted before linking, so that a concurrent pop never makes the size negative
+		size.fetch_add(1, std::memory_order_relaxed);
+		recordGuard guard(*this);
+		while (true)
+		{
+			uint64_t e = protectEnds(guard.record);
+			if (lastOf(e) == 0)
+			{
+				if (ends.compare_exchange_weak(e, makeEnds(index, index, stable)))
+					break;
+			}
+			else if (statusOf(e) == stable)
+			{
+				n->previousNode.store(lastOf(e));
+				guard.record->hazards[1].store(index);
+				uint64_t pushed = makeEnds(firstOf(e), index, pushedBack);
+				if (ends.compare_exchange_weak(e, pushed))
+				{
+					stabilizeBack(guard.record, pushed);
+					break;
+				}
+			}
+			else
+				stabilize(guard.record, e);
+		}
+	}
+	/** Links node in before the first one
+	 * @param index - index of the node
+	 */
+	void linkFront(uint32_t index)
+	{
+		node *n = nodeAt(index);
+		// Counted before linking, so that a concurrent pop never makes the size negative
+		size.fetch_add(1, std::memory_order_relaxed);
+		recordGuard guard(*this);
+		while (true)
+		{
+			uint64_t e = protectEnds(guard.record);
+			if (firstOf(e) == 0)
+			{
+				if (ends.compare_exchange_weak(e, makeEnds(index, index, stable)))
+					break;
+			}
+			else if (statusOf(e) == stable)
+			{
+				n->nextNode.store(firstOf(e));
+				guard.record->hazards[0].store(index);
+				uint64_t pushed = makeEnds(index, lastOf(e), pushedFront);
+				if (ends.compare_exchange_weak(e, pushed))
+				{
+					stabilizeFront(guard.record, pushed);
+					break;
+				}
+			}
+			else
+				stabilize(guard.record, e);
+		}
+	}
+	/** Unlinks the last node and passes its element to a callable
+	 * @param consume - callable taking T&, called before the element is destroyed
+	 * @return false if the list was empty
+	 */
+	template <class Consume>
+	bool unlinkBack(Consume consume)
+	{
+		recordGuard guard(*this);
+		uint64_t e;
+		while (true)
+		{
+			e = protectEnds(guard.record);
+			uint32_t last = lastOf(e);
+			if (last == 0)
+				return false;
+			if (last == firstOf(e))
+			{
+				if (ends.compare_exchange_weak(e, makeEnds(0, 0, stable)))
+					break;
+			}
+			else if (statusOf(e) == stable)
+			{
+				uint32_t previous = nodeAt(last)->previousNode.load();
+				if (ends.compare_exchange_weak(e, makeEnds(firstOf(e), previous, stable)))
+					break;
+			}
+			else
+				stabilize(guard.record, e);
+		}
+		size.fetch_sub(1, std::memory_order_relaxed);
+		node *n = nodeAt(lastOf(e));
+		try
+		{
+			consume(*n->data());
+		}
+		catch (...)
+		{
+			n->data()->~T();
+			retire(guard.record, lastOf(e));
+			throw;
+		}
+		n->data()->~T();
+		retire(guard.record, lastOf(e));
+		return true;
+	}
+	/** Unlinks the first node and passes its element to a callable
+	 * @param consume - callable taking T&, called before the element is destroyed
+	 * @return false if the list was empty
+	 */
+	template <class Consume>
+	bool unlinkFront(Consume consume)
+	{
+		recordGuard guard(*this);
+		uint64_t e;
+		while (true)
+		{
+			e = protectEnds(guard.record);
+			uint32_t first = firstOf(e);
+			if (first == 0)
+				return false;
+			if (first == lastOf(e))
+			{
+				if (ends.compare_exchange_weak(e, makeEnds(0, 0, stable)))
+					break;
+			}
+			else if (statusOf(e) == stable)
+			{
+				uint32_t next = nodeAt(first)->nextNode.load();
+				if (ends.compare_exchange_weak(e, makeEnds(next, lastOf(e), stable)))
+					break;
+			}
+			else
+				stabilize(guard.record, e);
+		}
+		size.fetch_sub(1, std::memory_order_relaxed);
+		node *n = nodeAt(firstOf(e));
+		try
+		{
+			consume(*n->data());
+		}
+		catch (...)
+		{
+			n->data()->~T();
+			retire(guard.record, firstOf(e));
+			throw;
+		}
+		n->data()->~T();
+		retire(guard.record, firstOf(e));
+		return true;
+	}
+
+public:
+	/** Default list constructor, no memory is allocated until the first push*/
+	concurrent_list()
+	{
+		for (auto &s : segments)
+			s.store(nullptr, std::memory_order_relaxed);
+	}
+	concurrent_list(const concurrent_list<T> &) = delete;
+	concurrent_list<T> &operator=(const concurrent_list<T> &) = delete;
+	/** List destructor, no other thread may use the list anymore*/
+	~concurrent_list()
+	{
+		uint64_t e = ends.load();
+		if (firstOf(e) != 0)
+		{
+			// Once every operation has returned the list is stable, so all 'nextNode' links are set
+			for (uint32_t i = firstOf(e);; i = nodeAt(i)->nextNode.load())
+			{
+				nodeAt(i)->data()->~T();
+				if (i == lastOf(e))
+					break;
+			}
+		}
+		for (hazardRecord *r = records.load(); r != nullptr;)
+		{
+			hazardRecord *next = r->nextRecord;
+			delete r;
+			r = next;
+		}
+		for (unsigned i = 0; i < segmentCount; i++)
+			delete[] segments[i].load();
+	}
+
+	/** Adds element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(const T &elem) { linkBack(createNode(elem)); }
+	/** Adds element at the end of the list, moving it into the node
+	 * @param elem - element to add
+	 */
+	void push_back(T &&elem) { linkBack(createNode(std::move(elem))); }
+	/** Adds element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(const T &elem) { linkFront(createNode(elem)); }
+	/** Adds element at the beginning of the list, moving it into the node
+	 * @param elem - element to add
+	 */
+	void push_front(T &&elem) { linkFront(createNode(std::move(elem))); }
+	/** Constructs element in place at the end of the list
+	 * @param args - arguments forwarded to the constructor of T
+	 */
+	template <class... Args>
+	void emplace_back(Args &&...args) { linkBack(createNode(std::forward<Args>(args)...)); }
+	/** Constructs element in place at the beginning of the list
+	 * @param args - arguments forwarded to the constructor of T
+	 */
+	template <class... Args>
+	void emplace_front(Args &&...args) { linkFront(createNode(std::forward<Args>(args)...)); }
+
+	/** Removes the last element if there is one
+	 * @param elem - set to the removed element
+	 * @return false if the list was empty
+	 */
+	bool try_pop_back(T &elem)
+	{
+		return unlinkBack([&](T &data)
+						  { elem = std::move(data); });
+	}
+	/** Removes the first element if there is one
+	 * @param elem - set to the removed element
+	 * @return false if the list was empty
+	 */
+	bool try_pop_front(T &elem)
+	{
+		return unlinkFront([&](T &data)
+						   { elem = std::move(data); });
+	}
+	/** Removes the last element, throws emptyList if there is none
+	 * @return Removed element
+	 */
+	T pop_back()
+	{
+		std::optional<T> elem;
+		if (!unlinkBack([&](T &data)
+						{ elem.emplace(std::move(data)); }))
+			throw myException(errorType::emptyList);
+		return std::move(*elem);
+	}
+	/** Removes the first element, throws emptyList if there is none
+	 * @return Removed element
+	 */
+	T pop_front()
+	{
+		std::optional<T> elem;
+		if (!unlinkFront([&](T &data)
+						 { elem.emplace(std::move(data)); }))
+			throw myException(errorType::emptyList);
+		return std::move(*elem);
+	}
+	/** Removes all elements, elements pushed by other threads in the meantime may stay*/
+	void clear()
+	{
+		while (unlinkFront([](T &) {}))
+			;
+	}
+	/** Checks if the list is empty
+	 * @return true if there are no elements at the moment of the call
+	 */
+	bool empty() const { return firstOf(ends.load()) == 0; }
+	/** Returns the number of elements, while other threads modify the list it is only an estimate
+	 * @return Number of elements
+	 */
+	size_t getSize() const { return size.load(std::memory_order_relaxed); }
+};
+
+#endif
@@ -0,0 +1,450 @@
+/**
+ * @file cow_list.h
+ * @brief Copy-on-write list - copies and snapshots share their chunks until one of them is modified
+ *
+ */
+
+#pragma once
+
+#ifndef COW_LIST_H
+#define COW_LIST_H
+
+#include "functions.h"
+
+#include <algorithm>
+#include <atomic>
+
+template <class T>
+/**Struct used to store data, block of consecutive elements of 'cow_list' class.
+ * A chunk shared by several lists is never modified, a list which wants to change it makes its own copy first.
+ */
+struct cowListChunk
+{
+	std::vector<T> elements; /**< Elements of the chunk*/
+};
+
+template <class T, size_t ChunkCapacity = 64>
+/**List with O(1) copies and snapshots.
+ *
+ * Elements are kept in chunks of up to ChunkCapacity elements, the list holds a shared table (spine) of pointers
+ * to its chunks. Copying the list only shares the spine. The first modification of a shared list copies the spine
+ * (n / ChunkCapacity pointers) and then every chunk it modifies (ChunkCapacity elements), chunks which were not
+ * touched stay shared, so a snapshot costs memory only for the parts changed after it was taken.
+ *
+ * A snapshot can be read by another thread while the original list is modified, as long as every cow_list object
+ * is used by one thread at a time. Iterators give read-only access and are invalidated by modification of their list.
+ */
+class cow_list
+{
+private:
+	using chunk = cowListChunk<T>;
+
+	/** Table of chunks shared by lists with the same contents*/
+	struct spine
+	{
+		std::vector<std::shared_ptr<chunk>> chunks; /**< Chunks in the order of the elements*/
+	};
+
+	std::shared_ptr<spine> chunks; /**< Chunks of the list, nullptr for an empty list*/
+	size_t size = 0;			   /**< Size of the list*/
+
+	/** Checks if a shared object is used only by this list, so it can be modified in place
+	 * @param p - pointer to the object
+	 * @return true if there is no other owner
+	 */
+	template <class U>
+	static bool unique(const std::shared_ptr<U> &p)
+	{
+		if (p.use_count() != 1)
+			return false;
+		// Pairs with the release of the last other owner, its reads are finished before we write
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+	/** Returns spine which can be modified, copies it if it is shared
+	 * @return Reference to the spine
+	 */
+	std::vector<std::shared_ptr<chunk>> &writableSpine()
+	{
+		if (chunks == nullptr)
+			chunks = std::make_shared<spine>();
+		else if (!unique(chunks))
+			chunks = std::make_shared<spine>(*chunks);
+		return chunks->chunks;
+	}
+	/** Returns chunk which can be modified, copies it (and the spine) if it is shared
+	 * @param c - index of the chunk
+	 * @return Reference to the elements of the chunk
+	 */
+	std::vector<T> &writableChunk(size_t c)
+	{
+		std::shared_ptr<chunk> &pointrr = writableSpine()[c];
+		if (!unique(pointrr))
+			pointrr = std::make_shared<chunk>(*pointrr);
+		return pointrr->elements;
+	}
+	/** Creates empty chunk and puts it into the spine
+	 * @param c - index the new chunk will have
+	 * @return Reference to the elements of the new chunk
+	 */
+	std::vector<T> &insertChunk(size_t c)
+	{
+		auto &spineChunks = writableSpine();
+		auto created = spineChunks.insert(spineChunks.begin() + c, std::make_shared<chunk>());
+		(*created)->elements.reserve(ChunkCapacity);
+		return (*created)->elements;
+	}
+	/** Removes empty chunk from the spine
+	 * @param c - index of the chunk
+	 */
+	void eraseChunk(size_t c)
+	{
+		auto &spineChunks = writableSpine();
+		spineChunks.erase(spineChunks.begin() + c);
+		if (spineChunks.empty())
+			chunks.reset();
+	}
+	/** Finds chunk holding element at given position
+	 * @param position - position of the element, lower than size
+	 * @param offset - set to the position of the element inside the found chunk
+	 * @return Index of the chunk
+	 */
+	size_t locate(size_t position, size_t &offset) const
+	{
+		const auto &spineChunks = chunks->chunks;
+		if (position < size / 2)
+		{
+			size_t c = 0;
+			while (position >= spineChunks[c]->elements.size())
+				position -= spineChunks[c++]->elements.size();
+			offset = position;
+			return c;
+		}
+		size_t c = spineChunks.size() - 1;
+		size_t fromEnd = size - position;
+		while (fromEnd > spineChunks[c]->elements.size())
+			fromEnd -= spineChunks[c--]->elements.size();
+		offset = spineChunks[c]->elements.size() - fromEnd;
+		return c;
+	}
+	/** Removes element from chunk, frees the chunk when it gets empty
+	 * @param c - index of the chunk
+	 * @param offset - position of the element inside the chunk
+	 * @return Removed element
+	 */
+	T eraseFromChunk(size_t c, size_t offset)
+	{
+		std::vector<T> &elements = writableChunk(c);
+		T val = std::move(elements[offset]);
+		elements.erase(elements.begin() + offset);
+		size--;
+		if (elements.empty())
+			eraseChunk(c);
+		return val;
+	}
+
+public:
+	/** Default list constructor, creates blank list*/
+	cow_list() = default;
+	/** Creates list with the elements of a list<T>
+	 * @param otherList - list to copy the elements from
+	 */
+	explicit cow_list(list<T> &otherList)
+	{
+		for (auto &elem : otherList)
+			push_back(elem);
+	}
+	/** Copy constructor, O(1) - the lists share all chunks until one of them is modified*/
+	cow_list(const cow_list &otherList) = default;
+	/** Move constructor*/
+	cow_list(cow_list &&otherList) noexcept : chunks(std::move(otherList.chunks)), size(otherList.size) { otherList.size = 0; }
+	/** Copy assignment operator, O(1) - the lists share all chunks until one of them is modified
+	 * @param otherList - the list to copy the contents from
+	 * @return A reference to the current list with the copied contents
+	 */
+	cow_list &operator=(const cow_list &otherList) = default;
+	/** Move assignment operator
+	 * @param otherList - the list to move the contents from
+	 * @return A reference to the current list with the moved contents
+	 */
+	cow_list &operator=(cow_list &&otherList) noexcept
+	{
+		if (this != &otherList)
+		{
+			chunks = std::move(otherList.chunks);
+			size = otherList.size;
+			otherList.size = 0;
+		}
+		return *this;
+	}
+	/** Takes point-in-time view of the list in O(1), later changes of this list do not affect it
+	 * @return Copy of the list sharing all chunks with it
+	 */
+	cow_list snapshot() const { return *this; }
+
+	/** Method which allows to add element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(T elem)
+	{
+		if (chunks == nullptr || chunks->chunks.back()->elements.size() == ChunkCapacity)
+			insertChunk(chunks == nullptr ? 0 : chunks->chunks.size()).push_back(std::move(elem));
+		else
+			writableChunk(chunks->chunks.size() - 1).push_back(std::move(elem));
+		size++;
+	}
+	/** Method which allows to add element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(T elem)
+	{
+		if (chunks == nullptr || chunks->chunks.front()->elements.size() == ChunkCapacity)
+			insertChunk(0).push_back(std::move(elem));
+		else
+		{
+			std::vector<T> &elements = writableChunk(0);
+			elements.insert(elements.begin(), std::move(elem));
+		}
+		size++;
+	}
+	/** Method which inserts element at given position, full chunk is split in two
+	 * @param position - position of the new element, from 0 to size
+	 * @param elem - element to add
+	 */
+	void insert_at(size_t position, T elem)
+	{
+		if (position > size)
+			throw myException(errorType::outOfRange);
+		if (position == size)
+		{
+			push_back(std::move(elem));
+			return;
+		}
+		size_t offset;
+		size_t c = locate(position, offset);
+		std::vector<T> *elements = &writableChunk(c);
+		if (elements->size() == ChunkCapacity)
+		{
+			std::vector<T> &second = insertChunk(c + 1);
+			size_t half = ChunkCapacity / 2;
+			std::move(elements->begin() + half, elements->end(), std::back_inserter(second));
+			elements->resize(half);
+			if (offset > half)
+			{
+				offset -= half;
+				elements = &second;
+			}
+		}
+		elements->insert(elements->begin() + offset, std::move(elem));
+		size++;
+	}
+	/** Returns the last element, copies its chunk if it is shared
+	 * @return Reference to the last element
+	 */
+	T &back()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return writableChunk(chunks->chunks.size() - 1).back();
+	}
+	/** Returns the first element, copies its chunk if it is shared
+	 * @return Reference to the first element
+	 */
+	T &front()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return writableChunk(0).front();
+	}
+	/** Returns element at given position, copies its chunk if it is shared
+	 * @param position - position of the element
+	 * @return Reference to the element
+	 */
+	T &at(size_t position)
+	{
+		if (position >= size)
+			throw myException(errorType::outOfRange);
+		size_t offset;
+		size_t c = locate(position, offset);
+		return writableChunk(c)[offset];
+	}
+	/** Returns element at given position without copying anything
+	 * @param position - position of the element
+	 * @return Reference to the element
+	 */
+	const T &at(size_t position) const
+	{
+		if (position >= size)
+			throw myException(errorType::outOfRange);
+		size_t offset;
+		size_t c = locate(position, offset);
+		return chunks->chunks[c]->elements[offset];
+	}
+	/** Method which checks if the list is empty
+	 * @return true if the list is empty, false otherwise
+	 */
+	bool empty() const { return size == 0; }
+	/** Returns the number of elements in the list
+	 * @return The number of elements in the list
+	 */
+	size_t getSize() const { return size; }
+	/** Method which allows to pop last element from the list
+	 * @return Deleted element
+	 */
+	T pop_back()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		size_t c = chunks->chunks.size() - 1;
+		return eraseFromChunk(c, chunks->chunks[c]->elements.size() - 1);
+	}
+	/** Method which allows to pop first element from the list
+	 * @return Deleted element
+	 */
+	T pop_front()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return eraseFromChunk(0, 0);
+	}
+	/** Method which allows to pop element in a chosen position in the list
+	 * @param position - position of the element to pop
+	 * @return Deleted element
+	 */
+	T pop_specified_position(int position)
+	{
+		if (position < 0 || static_cast<size_t>(position) >= size)
+			throw myException(errorType::outOfRange);
+		size_t offset;
+		size_t c = locate(static_cast<size_t>(position), offset);
+		return eraseFromChunk(c, offset);
+	}
+	/** Method displays all elements of the list*/
+	void display() const
+	{
+		if (size == 0)
+		{
+			std::cout << "\t/Empty list!/" << std::endl;
+			return;
+		}
+		for (const T &elem : *this)
+			std::cout << elem << '\n';
+		std::cout << std::flush;
+	}
+	/** Search for an element in the list
+	 * @param elem - the elements to search for
+	 */
+	void search(const T &elem) const
+	{
+		int elemCounter = 0;
+		bool elemFound = false;
+		for (const T &data : *this)
+		{
+			if (elem == data)
+			{
+				std::cout << data << " at [" << elemCounter << "] position." << std::endl;
+				elemFound = true;
+			}
+			++elemCounter;
+		}
+		if (!elemFound)
+			std::cout << elem << " not found." << std::endl;
+	}
+	/** Sorts the elements in the list using operator< (stable)*/
+	void sort()
+	{
+		sort([](const T &a, const T &b)
+			 { return a < b; });
+	}
+	/** Sorts the elements in the list using given comparator. Sorted elements are put into new chunks,
+	 * so snapshots taken before keep the old order. Sort is stable.
+	 * @param comp - callable returning true if the first argument should go before the second one
+	 */
+	template <class Compare>
+	void sort(Compare comp)
+	{
+		std::vector<T> buffer(begin(), end());
+		std::stable_sort(buffer.begin(), buffer.end(), comp);
+		clear();
+		for (T &elem : buffer)
+			push_back(std::move(elem));
+	}
+	/** Removes all elements, chunks still used by snapshots stay alive*/
+	void clear()
+	{
+		chunks.reset();
+		size = 0;
+	}
+
+	/** Bidirectional iterator class with read-only access, remembers chunk and position inside it*/
+	class iterator
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T *;
+		using reference = const T &;
+
+		/** Constructor for an iterator object
+		 * @param _chunks - chunks of the list, nullptr for an empty list
+		 * @param c - index of the chunk, number of chunks for end()
+		 * @param _offset - position of the element inside the chunk
+		 */
+		iterator(const spine *_chunks, size_t c, size_t _offset) : chunks(_chunks), current(c), offset(_offset) {}
+		/** Dereference operator
+		 * @return Returns reference to the element
+		 */
+		const T &operator*() const { return chunks->chunks[current]->elements[offset]; }
+		/** Gives access to members of the element*/
+		const T *operator->() const { return &**this; }
+		/** Increment operator - iterator is moved to the next element in the list
+		 * @return reference to the iterator
+		 */
+		iterator &operator++()
+		{
+			if (++offset == chunks->chunks[current]->elements.size())
+			{
+				++current;
+				offset = 0;
+			}
+			return *this;
+		}
+		/** Decrement operator - iterator is moved to the previous element in the list, end() can be decremented
+		 * @return reference to the iterator
+		 */
+		iterator &operator--()
+		{
+			if (offset == 0)
+				offset = chunks->chunks[--current]->elements.size();
+			--offset;
+			return *this;
+		}
+		/** Equality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the same element, false otherwise
+		 */
+		bool operator==(const iterator &other) const { return current == other.current && offset == other.offset; }
+		/** Inequality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to different elements, false otherwise
+		 */
+		bool operator!=(const iterator &other) const { return !(*this == other); }
+
+	private:
+		const spine *chunks; /**< Chunks of the list*/
+		size_t current;		 /**< Index of the chunk of the element*/
+		size_t offset;		 /**< Position of the element inside the chunk*/
+	};
+
+	/** Returns an iterator pointing to the first element of the list
+	 * @return Iterator pointing to the first element of the list
+	 */
+	iterator begin() const { return iterator(chunks.get(), 0, 0); }
+	/** Returns an iterator pointing to the end of the list
+	 * @return Iterator pointing to the end of the list
+	 */
+	iterator end() const { return iterator(chunks.get(), chunks == nullptr ? 0 : chunks->chunks.size(), 0); }
+};
+
+#endif /* COW_LIST_H */
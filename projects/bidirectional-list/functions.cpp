@@ -8,15 +8,28 @@
 
 #include "functions.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 std::ostream &operator<<(std::ostream &_stream, const person &_person)
 {
-    _stream << _person.name << " " << _person.age;
+    _stream << _person.name->text << " " << _person.age;
     return _stream;
 }
 
 std::istream &operator>>(std::istream &in, person &_person)
 {
-    in >> _person.name >> _person.age;
+    std::string name;
+    if (in >> name >> _person.age)
+        _person.name = nameTable::instance().intern(name);
     return in;
 }
 
@@ -25,14 +38,69 @@ void gap()
     std::cout << "\n\n----------------------------\n\n";
 }
 
-void person::setName(std::string _name)
+nameTable &nameTable::instance()
+{
+    static nameTable table;
+    return table;
+}
+
+const internedName *nameTable::intern(std::string_view text)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = lookup.find(text);
+    if (found != lookup.end())
+        return found->second;
+
+    internedName *entry = &entries.emplace_back(text);
+    lookup.emplace(entry->text, entry);
+    auto position = ordered.emplace(entry->text, entry).first;
+
+    // Ranks of the neighbours are exclusive bounds, 0 and UINT64_MAX are never given to a name
+    uint64_t low = position == ordered.begin() ? 0 : std::prev(position)->second->rank.load(std::memory_order_relaxed);
+    uint64_t high = std::next(position) == ordered.end() ? UINT64_MAX : std::next(position)->second->rank.load(std::memory_order_relaxed);
+    uint64_t rank = low + (high - low) / 2;
+    if (position != ordered.begin() && high == UINT64_MAX && high - low > rankStep)
+        rank = low + rankStep;
+    else if (std::next(position) != ordered.end() && low == 0 && high > rankStep)
+        rank = high - rankStep;
+    if (rank <= low || rank >= high)
+        reassignRanks();
+    else
+        entry->rank.store(rank, std::memory_order_relaxed);
+    return entry;
+}
+
+void nameTable::reassignRanks()
+{
+    uint64_t step = UINT64_MAX / (ordered.size() + 1);
+    uint64_t rank = 0;
+    for (auto &name : ordered)
+    {
+        rank += step;
+        name.second->rank.store(rank, std::memory_order_relaxed);
+    }
+}
+
+size_t nameTable::getSize()
 {
-    name = _name;
+    std::lock_guard<std::mutex> guard(lock);
+    return entries.size();
+}
+
+const internedName *person::defaultName()
+{
+    static const internedName *jan = nameTable::instance().intern("Jan");
+    return jan;
+}
+
+void person::setName(std::string_view _name)
+{
+    name = nameTable::instance().intern(_name);
 }
 
 std::string person::getName()
 {
-    return name;
+    return name->text;
 }
 
 void person::setAge(int _age)
@@ -45,56 +113,246 @@ int person::getAge()
     return age;
 }
 
-bool person::operator<(const person &other)
+#ifdef _WIN32
+mappedFile::mappedFile(const std::string &fileName)
 {
-    if (age == other.age)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw myException(errorType::fileNotOpened);
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
     {
-        if (name == other.name)
-        {
-            return false;
-        }
-        else if (name < other.name)
-        {
-            return true;
-        }
-        else
+        CloseHandle(file);
+        throw myException(errorType::fileNotOpened);
+    }
+    fileHandle = file;
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0)
+        return;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        throw myException(errorType::fileNotOpened);
+    }
+    mapHandle = mapping;
+    data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw myException(errorType::fileNotOpened);
+    }
+}
+
+mappedFile::~mappedFile()
+{
+    if (data != nullptr)
+        UnmapViewOfFile(data);
+    if (mapHandle != nullptr)
+        CloseHandle(mapHandle);
+    if (fileHandle != nullptr)
+        CloseHandle(fileHandle);
+}
+#else
+mappedFile::mappedFile(const std::string &fileName)
+{
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw myException(errorType::fileNotOpened);
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        throw myException(errorType::fileNotOpened);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length != 0)
+    {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
         {
-            return false;
+            close(fd);
+            throw myException(errorType::fileNotOpened);
         }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapping);
     }
-    else if (age < other.age)
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+mappedFile::~mappedFile()
+{
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), length);
+}
+#endif
+
+listThreadPool::listThreadPool(unsigned threadCount)
+{
+    for (unsigned i = 0; i < threadCount; i++)
+        workers.emplace_back([this]
+                             { work(); });
+}
+
+listThreadPool::~listThreadPool()
+{
     {
-        return true;
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
     }
-    else
+    taskAdded.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+listThreadPool &listThreadPool::instance()
+{
+    static listThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+    return pool;
+}
+
+void listThreadPool::work()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
     {
-        return false;
+        taskAdded.wait(guard, [this]
+                       { return stopping || !tasks.empty(); });
+        if (tasks.empty())
+            return;
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        guard.unlock();
+        task();
+        guard.lock();
     }
 }
 
-bool person::operator>(const person &other)
+void listThreadPool::run(unsigned count, const std::function<void(unsigned)> &task)
 {
-    if (age == other.age)
+    if (count == 0)
+        return;
+    if (count == 1 || workers.empty())
+    {
+        for (unsigned i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+
+    unsigned remaining = count; // guarded by 'lock', so the batch can not end while a task still uses this frame
+    std::exception_ptr error;
+    std::mutex errorLock;
+    // Runs one task and wakes the thread which started the batch after the last one
+    auto runTask = [&](unsigned i)
     {
-        if (name == other.name)
+        try
         {
-            return false;
+            task(i);
         }
-        else if (name > other.name)
+        catch (...)
         {
-            return true;
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error)
+                error = std::current_exception();
         }
-        else
+        std::lock_guard<std::mutex> guard(lock);
+        if (--remaining == 0)
+            batchFinished.notify_all();
+    };
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (unsigned i = 1; i < count; i++)
+            tasks.emplace_back([&runTask, i]
+                               { runTask(i); });
+    }
+    taskAdded.notify_all();
+    runTask(0);
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (remaining != 0)
+    {
+        if (tasks.empty())
         {
-            return false;
+            batchFinished.wait(guard);
+            continue;
         }
+        std::function<void()> queued = std::move(tasks.front());
+        tasks.pop_front();
+        guard.unlock();
+        queued();
+        guard.lock();
     }
-    else if (age > other.age)
+    guard.unlock();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+bool listParser<person>::parse(std::string_view line, person &elem)
+{
+    const char *last = line.data() + line.size();
+    const char *nameBegin = skipBlanks(line.data(), last);
+    const char *nameEnd = nameBegin;
+    while (nameEnd != last && *nameEnd != ' ' && *nameEnd != '\t')
+        ++nameEnd;
+    if (nameBegin == nameEnd)
+        return false;
+    const char *ageBegin = skipBlanks(nameEnd, last);
+    if (ageBegin != last && *ageBegin == '+')
+        ++ageBegin;
+    int age;
+    if (std::from_chars(ageBegin, last, age).ec != std::errc())
+        return false;
+    elem.setName(std::string_view(nameBegin, static_cast<size_t>(nameEnd - nameBegin)));
+    elem.setAge(age);
+    return true;
+}
+
+snapshotHeader snapshotHeader::make(uint32_t _flags, uint64_t _count, uint32_t _elementSize)
+{
+    snapshotHeader header;
+    std::memcpy(header.magic, "BDLIST\0\0", sizeof(header.magic));
+    header.version = currentVersion;
+    header.flags = _flags;
+    header.count = _count;
+    header.elementSize = _elementSize;
+    header.checksum = header.computeChecksum();
+    return header;
+}
+
+uint32_t snapshotHeader::computeChecksum() const
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(this);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(snapshotHeader, checksum); i++)
     {
-        return true;
+        hash ^= bytes[i];
+        hash *= 16777619u;
     }
-    else
-    {
+    return hash;
+}
+
+bool snapshotHeader::valid() const
+{
+    return std::memcmp(magic, "BDLIST\0\0", sizeof(magic)) == 0 && version == currentVersion && checksum == computeChecksum();
+}
+
+void listSerializer<person>::write(std::string &buffer, const person &elem)
+{
+    int32_t age = elem.age;
+    buffer.append(reinterpret_cast<const char *>(&age), sizeof(age));
+    buffer += elem.name->text;
+}
+
+bool listSerializer<person>::read(std::string_view payload, person &elem)
+{
+    int32_t age;
+    if (payload.size() < sizeof(age))
         return false;
-    }
+    std::memcpy(&age, payload.data(), sizeof(age));
+    elem.age = age;
+    elem.name = nameTable::instance().intern(payload.substr(sizeof(age)));
+    return true;
 }
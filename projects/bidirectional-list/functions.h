@@ -18,6 +18,29 @@
 #include <memory>
 #include <exception>
 #include <iterator>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <type_traits>
+#include <unordered_map>
+#include <map>
+#include <vector>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <optional>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <memory_resource>
+#include <future>
 
 constexpr auto LOGO = R"(
 
@@ -36,6 +59,10 @@ enum class errorType
 	emptyList,
 	nonEmptyList,
 	fileNotOpened,
+	outOfRange,
+	noIndex,
+	invalidFormat,
+	differentResource,
 	undefined
 };
 
@@ -64,6 +91,14 @@ public:
 			return "List is non empty";
 		case errorType::fileNotOpened:
 			return "File could not be opened";
+		case errorType::outOfRange:
+			return "Position is out of range";
+		case errorType::noIndex:
+			return "List has no index with this key type";
+		case errorType::invalidFormat:
+			return "File is not a valid list snapshot";
+		case errorType::differentResource:
+			return "Lists use different memory resources";
 		default:
 			return "Unknown error.";
 		}
@@ -74,43 +109,1019 @@ template <class T>
 /**Struct used to store data, node of 'list' class*/
 struct listNode
 {
-	T data;										  /**< Data stored in node*/
-	std::shared_ptr<listNode<T>> previousNodePtr; /**< Pointer, which points to the previous element of the list*/
-	std::shared_ptr<listNode<T>> nextNodePtr;	  /**< Pointer, which points to the next element of the list*/
+	T data;								 /**< Data stored in node*/
+	listNode<T> *previousNodePtr = nullptr; /**< Pointer, which points to the previous element of the list*/
+	listNode<T> *nextNodePtr = nullptr;	 /**< Pointer, which points to the next element of the list*/
 	/** Default node constructor, node doesn't hold any data*/
 	listNode() = default;
+	/** Node constructor, which assigns data to the node, links are left empty
+	 * @param elem - data to store in the node
+	 */
+	listNode(const T &elem) : data(elem) {}
+	/** Node constructor, which constructs data in place from given arguments, links are left empty
+	 * @param args - arguments passed to the constructor of T
+	 */
+	template <class... Args>
+	explicit listNode(std::in_place_t, Args &&...args) : data(std::forward<Args>(args)...) {}
 	/** Node constructor, which assigns data and pointers to the previous and the next node
 	 * @param other - we take values from 'other' list node and we assign it to another
 	 */
 	listNode(listNode<T> &other) : data(other.data), previousNodePtr(other.previousNodePtr), nextNodePtr(other.nextNodePtr) {}
 };
 
+template <class T>
+/**Pool allocator for list nodes. Memory is taken from a std::pmr::memory_resource (the heap by default) in slabs holding many nodes,
+ * nodes freed by the list are kept on a free list and handed out again before a new slab is requested.
+ * The pool only manages raw memory, constructing and destroying nodes is up to the list.
+ *
+ * Pools are shared through std::shared_ptr. When nodes are spliced between two lists with different pools,
+ * one pool adopts all slabs of the other one and the emptied pool remembers where they went ('mergedInto'),
+ * so every list still holding it can find the pool that owns its nodes; requests made to the emptied pool are passed on.
+ * Once a pool has adopted another one it is used by more than one list, from then on it locks its mutex
+ * in every operation, so lists which exchanged nodes can still be used from different threads.
+ * A pool used by a single list is never locked; locking makes allocation from a shared pool a few times slower.
+ */
+class nodePool : public std::enable_shared_from_this<nodePool<T>>
+{
+private:
+	/** Single slot of a slab, holds either a node or a link to the next free slot*/
+	union slot
+	{
+		slot *nextFree;										  /**< Next free slot, valid only while the slot is unused*/
+		alignas(listNode<T>) unsigned char storage[sizeof(listNode<T>)]; /**< Memory for one node*/
+	};
+	/** Block of slots allocated at once, the header is followed by the slots in the same allocation*/
+	struct slab
+	{
+		slot *slots;	 /**< Array of slots*/
+		size_t capacity; /**< Number of slots in the array*/
+		slab *nextSlab;	 /**< Previously allocated slab*/
+	};
+
+	static constexpr size_t firstSlabSize = 16;	 /**< Number of slots in the first slab*/
+	static constexpr size_t maxSlabSize = 4096; /**< Upper bound for the number of slots in one slab*/
+	static constexpr size_t slabAlignment = std::max(alignof(slab), alignof(slot)); /**< Alignment of the memory of a slab*/
+	static constexpr size_t slotsOffset = (sizeof(slab) + alignof(slot) - 1) / alignof(slot) * alignof(slot); /**< Distance between the header of a slab and its first slot*/
+
+	std::pmr::memory_resource *const resource; /**< Resource the slabs are taken from*/
+
+	slab *slabs = nullptr;		/**< Most recently allocated slab*/
+	slab *oldestSlab = nullptr; /**< First allocated slab, end of the 'slabs' chain*/
+	slot *freeList = nullptr;	/**< First recycled slot*/
+	slot *freeTail = nullptr;	/**< Last recycled slot*/
+	size_t used = 0;			/**< Number of slots taken from the newest slab*/
+	size_t totalCapacity = 0;	/**< Number of slots in all slabs*/
+
+	std::shared_ptr<nodePool<T>> mergedInto; /**< Pool which adopted slabs of this one, nullptr if it still owns them*/
+	std::mutex lock;						  /**< Guards the pool once it is shared*/
+	std::atomic<bool> shared{false};		  /**< Whether more than one list may use the pool (or it was merged), the mutex is used only then*/
+
+	/** Takes a new slab from the resource and makes it the newest one, throws std::length_error if its size does not fit in size_t
+	 * @param capacity - number of slots of the slab
+	 */
+	void pushSlab(size_t capacity)
+	{
+		if (capacity > (std::numeric_limits<size_t>::max() - slotsOffset) / sizeof(slot))
+			throw std::length_error("nodePool: too many nodes in one slab");
+		void *memory = resource->allocate(slotsOffset + capacity * sizeof(slot), slabAlignment);
+		slabs = new (memory) slab{reinterpret_cast<slot *>(static_cast<unsigned char *>(memory) + slotsOffset), capacity, slabs};
+		if (oldestSlab == nullptr)
+			oldestSlab = slabs;
+		used = 0;
+		totalCapacity += capacity;
+	}
+	/** Gives memory of a slab back to the resource
+	 * @param s - slab to free, it has to be unlinked from the chain of slabs
+	 */
+	void freeSlab(slab *s) { resource->deallocate(s, slotsOffset + s->capacity * sizeof(slot), slabAlignment); }
+	/** Allocates a new slab, twice as big as the previous one (up to maxSlabSize)*/
+	void grow()
+	{
+		size_t capacity = slabs == nullptr ? firstSlabSize : slabs->capacity * 2;
+		if (capacity > maxSlabSize)
+			capacity = maxSlabSize;
+		pushSlab(capacity);
+	}
+	/** allocate() without locking*/
+	void *allocateSlot()
+	{
+		if (freeList != nullptr)
+		{
+			slot *s = freeList;
+			freeList = s->nextFree;
+			if (freeList == nullptr)
+				freeTail = nullptr;
+			return s;
+		}
+		if (slabs == nullptr || used == slabs->capacity)
+			grow();
+		return &slabs->slots[used++];
+	}
+	/** deallocate() without locking*/
+	void freeSlot(void *p)
+	{
+		slot *s = static_cast<slot *>(p);
+		s->nextFree = freeList;
+		freeList = s;
+		if (freeTail == nullptr)
+			freeTail = s;
+	}
+	/** allocate() of a shared pool, kept out of the unlocked path so that it stays cheap*/
+	void *allocateShared()
+	{
+		std::unique_lock<std::mutex> locked(lock);
+		if (mergedInto)
+		{
+			locked.unlock();
+			return mergedInto->allocate();
+		}
+		return allocateSlot();
+	}
+	/** deallocate() of a shared pool*/
+	void deallocateShared(void *p)
+	{
+		std::unique_lock<std::mutex> locked(lock);
+		if (mergedInto)
+		{
+			locked.unlock();
+			mergedInto->deallocate(p);
+			return;
+		}
+		freeSlot(p);
+	}
+	/** reserve() without locking*/
+	void reserveSlots(size_t count)
+	{
+		size_t available = slabs == nullptr ? 0 : slabs->capacity - used;
+		if (available >= count)
+			return;
+		// Unused slots of the current slab go to the free list, so that nothing is lost
+		for (size_t i = used; slabs != nullptr && i < slabs->capacity; i++)
+			freeSlot(&slabs->slots[i]);
+		if (slabs != nullptr)
+			used = slabs->capacity;
+		pushSlab(count);
+	}
+
+public:
+	/** Pool constructor, no memory is allocated until the first node is requested
+	 * @param _resource - resource the slabs are taken from, e.g. std::pmr::monotonic_buffer_resource to make freeing them free
+	 */
+	explicit nodePool(std::pmr::memory_resource *_resource = std::pmr::new_delete_resource()) : resource(_resource) {}
+	nodePool(const nodePool<T> &) = delete;
+	nodePool<T> &operator=(const nodePool<T> &) = delete;
+
+	/** Pool destructor, gives all slabs back to the resource*/
+	~nodePool() { release(); }
+	/** Returns the pool which adopted slabs of this one
+	 * @return Pointer to the pool, nullptr if this pool still owns its slabs
+	 */
+	std::shared_ptr<nodePool<T>> owner()
+	{
+		if (!shared.load(std::memory_order_acquire))
+			return nullptr;
+		std::lock_guard<std::mutex> locked(lock);
+		return mergedInto;
+	}
+	/** Returns memory for one node, recycled slots are used first
+	 * @return Pointer to uninitialized memory big enough for listNode<T>
+	 */
+	void *allocate()
+	{
+		if (shared.load(std::memory_order_acquire))
+			return allocateShared();
+		return allocateSlot();
+	}
+	/** Puts memory of an already destroyed node back on the free list
+	 * @param p - memory returned earlier by allocate()
+	 */
+	void deallocate(void *p)
+	{
+		if (shared.load(std::memory_order_acquire))
+			deallocateShared(p);
+		else
+			freeSlot(p);
+	}
+	/** Takes over all slabs and free slots of the other pool, nodes allocated from it stay where they are.
+	 * Costs O(1), unused slots of the other pool's newest slab (at most maxSlabSize) are moved to the free list.
+	 * The other pool passes all further requests to this one, which from now on locks itself.
+	 * Both pools have to use equal resources, even if one of them is empty (a pool never changes its resource),
+	 * otherwise errorType::differentResource is thrown and nothing changes.
+	 * @param other - pool to empty, it keeps no memory afterwards
+	 */
+	void adopt(nodePool<T> &other)
+	{
+		if (this == &other)
+			return;
+		std::unique_lock<std::mutex> mine(lock, std::defer_lock);
+		std::unique_lock<std::mutex> theirs(other.lock, std::defer_lock);
+		std::lock(mine, theirs);
+		// Another list sharing one of the pools may have merged it meanwhile, then its successor is used
+		if (mergedInto || other.mergedInto)
+		{
+			std::shared_ptr<nodePool<T>> target = mergedInto ? mergedInto : this->shared_from_this();
+			std::shared_ptr<nodePool<T>> source = other.mergedInto ? other.mergedInto : other.shared_from_this();
+			mine.unlock();
+			theirs.unlock();
+			target->adopt(*source);
+			return;
+		}
+		if (!resource->is_equal(*other.resource))
+			throw myException(errorType::differentResource);
+		if (other.slabs != nullptr)
+		{
+			for (size_t i = other.used; i < other.slabs->capacity; i++)
+				other.freeSlot(&other.slabs->slots[i]);
+			other.used = other.slabs->capacity;
+			if (slabs == nullptr)
+			{
+				slabs = other.slabs;
+				used = other.used;
+			}
+			else
+				oldestSlab->nextSlab = other.slabs;
+			oldestSlab = other.oldestSlab;
+			if (other.freeList != nullptr)
+			{
+				other.freeTail->nextFree = freeList;
+				if (freeList == nullptr)
+					freeTail = other.freeTail;
+				freeList = other.freeList;
+			}
+			totalCapacity += other.totalCapacity;
+			other.slabs = nullptr;
+			other.oldestSlab = nullptr;
+			other.freeList = nullptr;
+			other.freeTail = nullptr;
+			other.used = 0;
+			other.totalCapacity = 0;
+		}
+		other.mergedInto = this->shared_from_this();
+		other.shared.store(true, std::memory_order_release);
+		shared.store(true, std::memory_order_release);
+	}
+	/** Forgets all nodes at once without visiting them, only the newest slab is kept for further allocations.
+	 * Nodes taken from the pool must not need destruction and must not be used afterwards.
+	 */
+	void reset()
+	{
+		if (slabs == nullptr)
+			return;
+		while (slabs->nextSlab != nullptr)
+		{
+			slab *tmp = slabs->nextSlab;
+			slabs->nextSlab = tmp->nextSlab;
+			freeSlab(tmp);
+		}
+		oldestSlab = slabs;
+		freeList = nullptr;
+		freeTail = nullptr;
+		used = 0;
+		totalCapacity = slabs->capacity;
+	}
+	/** Gives all slabs back to the resource, every node taken from the pool has to be destroyed before*/
+	void release()
+	{
+		while (slabs != nullptr)
+		{
+			slab *tmp = slabs;
+			slabs = slabs->nextSlab;
+			freeSlab(tmp);
+		}
+		oldestSlab = nullptr;
+		freeList = nullptr;
+		freeTail = nullptr;
+		used = 0;
+		totalCapacity = 0;
+	}
+	/** Returns the number of nodes the pool can hold without asking the heap for more memory
+	 * @return Number of slots in all slabs
+	 */
+	size_t capacity()
+	{
+		std::unique_lock<std::mutex> locked(lock, std::defer_lock);
+		if (shared.load(std::memory_order_acquire))
+		{
+			locked.lock();
+			if (mergedInto)
+			{
+				locked.unlock();
+				return mergedInto->capacity();
+			}
+		}
+		return totalCapacity;
+	}
+	/** Returns the resource the slabs are taken from
+	 * @return Pointer to the resource
+	 */
+	std::pmr::memory_resource *getResource() const { return resource; }
+	/** Makes sure that the next 'count' allocations do not ask the heap for memory, one slab is allocated for all of them
+	 * @param count - number of nodes about to be allocated
+	 */
+	void reserve(size_t count)
+	{
+		std::unique_lock<std::mutex> locked(lock, std::defer_lock);
+		if (shared.load(std::memory_order_acquire))
+		{
+			locked.lock();
+			if (mergedInto)
+			{
+				locked.unlock();
+				mergedInto->reserve(count);
+				return;
+			}
+		}
+		reserveSlots(count);
+	}
+	/** Returns memory for adjacent nodes, taken from the newest slab (a new one is allocated if it is too small)
+	 * @param count - number of nodes wanted, greater than 0; it is lowered to the number of nodes returned (at most maxSlabSize)
+	 * @return Pointer to uninitialized memory for an array of 'count' nodes
+	 */
+	listNode<T> *allocateRun(size_t &count)
+	{
+		static_assert(sizeof(slot) == sizeof(listNode<T>), "slots have to be laid out like an array of nodes");
+		std::unique_lock<std::mutex> locked(lock, std::defer_lock);
+		if (shared.load(std::memory_order_acquire))
+		{
+			locked.lock();
+			if (mergedInto)
+			{
+				locked.unlock();
+				return mergedInto->allocateRun(count);
+			}
+		}
+		if (count > maxSlabSize)
+			count = maxSlabSize;
+		reserveSlots(count);
+		slot *first = &slabs->slots[used];
+		used += count;
+		return reinterpret_cast<listNode<T> *>(first->storage);
+	}
+};
+
+/**Read-only memory mapping of a whole file, used by open() of the lists to scan the file in place*/
+class mappedFile
+{
+private:
+	const char *data = nullptr; /**< First byte of the file*/
+	size_t length = 0;			/**< Size of the file in bytes*/
+	void *fileHandle = nullptr; /**< Handle of the file (Windows only)*/
+	void *mapHandle = nullptr;	/**< Handle of the mapping (Windows only)*/
+
+public:
+	/** Maps file into memory, throws errorType::fileNotOpened if it cannot be opened or mapped
+	 * @param fileName - name of the file to map
+	 */
+	mappedFile(const std::string &fileName);
+	mappedFile(const mappedFile &) = delete;
+	mappedFile &operator=(const mappedFile &) = delete;
+	/** Unmaps the file*/
+	~mappedFile();
+	/** Returns pointer to the first byte of the file
+	 * @return Pointer to the first byte
+	 */
+	const char *begin() const { return data; }
+	/** Returns pointer past the last byte of the file
+	 * @return Pointer past the last byte
+	 */
+	const char *end() const { return data + length; }
+	/** Calls a callable for every line of the file, line breaks ("\n" or "\r\n") are not passed
+	 * @param onLine - callable taking std::string_view with contents of the line
+	 */
+	template <class Callback>
+	void forEachLine(Callback onLine) const
+	{
+		const char *pointrr = begin();
+		const char *fileEnd = end();
+		while (pointrr < fileEnd)
+		{
+			const char *lineEnd = static_cast<const char *>(std::memchr(pointrr, '\n', fileEnd - pointrr));
+			if (lineEnd == nullptr)
+				lineEnd = fileEnd;
+			const char *contentEnd = lineEnd;
+			if (contentEnd != pointrr && contentEnd[-1] == '\r')
+				--contentEnd;
+			onLine(std::string_view(pointrr, contentEnd - pointrr));
+			pointrr = lineEnd + 1;
+		}
+	}
+};
+
+/**Threads shared by the parallel algorithms of all lists (parallel_for_each() and the others).
+ * The pool is created on first use with one thread less than std::thread::hardware_concurrency(),
+ * the thread which starts a batch of tasks works on it too.
+ */
+class listThreadPool
+{
+private:
+	std::vector<std::thread> workers;		  /**< Threads of the pool*/
+	std::deque<std::function<void()>> tasks; /**< Tasks waiting for a thread*/
+	std::mutex lock;						  /**< Mutex guarding 'tasks' and 'stopping'*/
+	std::condition_variable taskAdded;		  /**< Signalled when a task is queued or the pool stops*/
+	std::condition_variable batchFinished;	  /**< Signalled when the last task of a batch finishes*/
+	bool stopping = false;					  /**< Set by the destructor to end the workers*/
+
+	/** Creates pool
+	 * @param threadCount - number of threads of the pool
+	 */
+	listThreadPool(unsigned threadCount);
+	/** Loop of a pool thread, runs tasks until the pool stops*/
+	void work();
+
+public:
+	listThreadPool(const listThreadPool &) = delete;
+	listThreadPool &operator=(const listThreadPool &) = delete;
+	/** Stops and joins all threads of the pool*/
+	~listThreadPool();
+	/** Returns pool shared by the whole program
+	 * @return Reference to the pool
+	 */
+	static listThreadPool &instance();
+	/** Returns number of threads which can work on a batch at once
+	 * @return Number of pool threads plus the calling one
+	 */
+	unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+	/** Runs task(0), task(1) ... task(count - 1) concurrently and waits until all of them finish.
+	 * While waiting the calling thread runs queued tasks, so tasks may start batches themselves.
+	 * If tasks throw, the first exception is rethrown after the whole batch has finished.
+	 * @param count - number of tasks
+	 * @param task - callable taking index of the task
+	 */
+	void run(unsigned count, const std::function<void(unsigned)> &task);
+};
+
+/**Header of a binary list snapshot written by list<T>::save_binary(). Numbers are stored in the native byte order.*/
+struct snapshotHeader
+{
+	char magic[8];		  /**< "BDLIST" followed by two zero bytes*/
+	uint32_t version;	  /**< Version of the format, currently 1*/
+	uint32_t flags;		  /**< rawRecords if elements were written as raw bytes*/
+	uint64_t count;		  /**< Number of elements*/
+	uint32_t elementSize; /**< sizeof(T) for raw records, 0 for length-prefixed ones*/
+	uint32_t checksum;	  /**< FNV-1a checksum of all previous fields*/
+
+	static constexpr uint32_t currentVersion = 1; /**< Version written by save_binary()*/
+	static constexpr uint32_t rawRecords = 1;	  /**< Flag - every record is sizeof(T) raw bytes without length*/
+
+	/** Creates header with given contents and computes its checksum
+	 * @param _flags - flags of the snapshot
+	 * @param _count - number of elements
+	 * @param _elementSize - size of one raw record, 0 for length-prefixed records
+	 * @return Ready to write header
+	 */
+	static snapshotHeader make(uint32_t _flags, uint64_t _count, uint32_t _elementSize);
+	/** Computes checksum of the header
+	 * @return FNV-1a checksum of all fields but 'checksum'
+	 */
+	uint32_t computeChecksum() const;
+	/** Checks magic, version and checksum of the header
+	 * @return true if the header is valid
+	 */
+	bool valid() const;
+};
+
+template <class T, class Enable = void>
+/**Customization point used by list<T>::open() to turn one line of a file into an element.
+ * The default parser reads the line with operator>>, like the list always did. Specializations can provide
+ * a faster parser, it gets the line without the end of line characters and writes straight into the element
+ * stored in the list node.
+ */
+struct listParser
+{
+	/** Parses one line
+	 * @param line - contents of the line
+	 * @param elem - element to fill
+	 * @return true if the line held an element, false if it should be skipped
+	 */
+	static bool parse(std::string_view line, T &elem)
+	{
+		std::istringstream ss{std::string(line)};
+		return static_cast<bool>(ss >> elem);
+	}
+};
+
+/** Skips spaces and tabs at the beginning of the text
+ * @param first - beginning of the text
+ * @param last - end of the text
+ * @return Pointer to the first other character (or last)
+ */
+inline const char *skipBlanks(const char *first, const char *last)
+{
+	while (first != last && (*first == ' ' || *first == '\t'))
+		++first;
+	return first;
+}
+
+template <class T>
+/**Parser for numbers, uses std::from_chars instead of streams*/
+struct listParser<T, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>>
+{
+	/** Parses one line holding a number
+	 * @param line - contents of the line
+	 * @param elem - element to fill
+	 * @return true if the line started with a number
+	 */
+	static bool parse(std::string_view line, T &elem)
+	{
+		const char *last = line.data() + line.size();
+		const char *first = skipBlanks(line.data(), last);
+		if (first != last && *first == '+')
+			++first;
+		return std::from_chars(first, last, elem).ec == std::errc();
+	}
+};
+
+template <>
+/**Parser for strings, takes the first word of the line like operator>> does*/
+struct listParser<std::string>
+{
+	/** Parses one line holding a word
+	 * @param line - contents of the line
+	 * @param elem - element to fill
+	 * @return true if the line held a word
+	 */
+	static bool parse(std::string_view line, std::string &elem)
+	{
+		const char *last = line.data() + line.size();
+		const char *first = skipBlanks(line.data(), last);
+		const char *wordEnd = first;
+		while (wordEnd != last && *wordEnd != ' ' && *wordEnd != '\t')
+			++wordEnd;
+		if (first == wordEnd)
+			return false;
+		elem.assign(first, wordEnd);
+		return true;
+	}
+};
+
+template <class T, class Enable = void>
+/**Customization point used by list<T>::save_binary()/open_binary() for elements which are not trivially copyable
+ * (trivially copyable elements are written as raw bytes, see listRawRecords). Every element becomes one length-prefixed record.
+ * The default serializer stores the text written by operator<< and reads it back with listParser<T>.
+ */
+struct listSerializer
+{
+	/** Appends record payload of the element to the buffer
+	 * @param buffer - output buffer
+	 * @param elem - element to write
+	 */
+	static void write(std::string &buffer, const T &elem)
+	{
+		std::ostringstream ss;
+		ss << elem;
+		buffer += ss.str();
+	}
+	/** Reads element from record payload
+	 * @param payload - bytes of the record
+	 * @param elem - element to fill
+	 * @return true if the payload was valid
+	 */
+	static bool read(std::string_view payload, T &elem) { return listParser<T>::parse(payload, elem); }
+};
+
+template <>
+/**Serializer for strings, the payload is the string itself*/
+struct listSerializer<std::string>
+{
+	/** Appends the string to the buffer
+	 * @param buffer - output buffer
+	 * @param elem - string to write
+	 */
+	static void write(std::string &buffer, const std::string &elem) { buffer += elem; }
+	/** Reads the string
+	 * @param payload - bytes of the record
+	 * @param elem - string to fill
+	 * @return Always true
+	 */
+	static bool read(std::string_view payload, std::string &elem)
+	{
+		elem.assign(payload.data(), payload.size());
+		return true;
+	}
+};
+
+template <class T>
+/**Tells list<T>::save_binary()/open_binary() to write elements as raw bytes, true for trivially copyable types.
+ * Trivially copyable types holding pointers (like person) specialize it as false and are written by listSerializer<T>.
+ */
+struct listRawRecords : std::is_trivially_copyable<T>
+{
+};
+
+template <class T>
+/**Interface of secondary indexes kept by 'list' class, the list reports every node it creates and destroys*/
+class listIndex
+{
+public:
+	/** Default index destructor*/
+	virtual ~listIndex() = default;
+	/** Adds node to the index
+	 * @param node - node which has just been created
+	 */
+	virtual void insert(listNode<T> *node) = 0;
+	/** Removes node from the index
+	 * @param node - node which is about to be destroyed
+	 */
+	virtual void erase(listNode<T> *node) = 0;
+	/** Removes all nodes from the index*/
+	virtual void clear() = 0;
+	/** Creates empty index of the same kind, used when the list is copied
+	 * @return New empty index
+	 */
+	virtual std::unique_ptr<listIndex<T>> cloneEmpty() const = 0;
+};
+
+template <class T, class Key>
+/**Hash index which groups nodes by key. Nodes with the same key are kept in a vector,
+ * position of every node in its vector is remembered, so both insertion and removal are O(1) average.
+ */
+class listKeyIndex : public listIndex<T>
+{
+private:
+	std::unordered_map<Key, std::vector<listNode<T> *>> nodesByKey; /**< Nodes grouped by key*/
+	std::unordered_map<const listNode<T> *, size_t> slots;			 /**< Position of every node in its group*/
+
+public:
+	/** Computes key of the element
+	 * @param elem - element stored in the list
+	 * @return Key of the element
+	 */
+	virtual Key keyOf(T &elem) = 0;
+	void insert(listNode<T> *node) override
+	{
+		std::vector<listNode<T> *> &group = nodesByKey[keyOf(node->data)];
+		slots[node] = group.size();
+		group.push_back(node);
+	}
+	void erase(listNode<T> *node) override
+	{
+		auto groupIt = nodesByKey.find(keyOf(node->data));
+		auto slotIt = slots.find(node);
+		if (groupIt == nodesByKey.end() || slotIt == slots.end())
+			return;
+		std::vector<listNode<T> *> &group = groupIt->second;
+		listNode<T> *moved = group.back();
+		group[slotIt->second] = moved;
+		slots[moved] = slotIt->second;
+		group.pop_back();
+		slots.erase(node);
+		if (group.empty())
+			nodesByKey.erase(groupIt);
+	}
+	void clear() override
+	{
+		nodesByKey.clear();
+		slots.clear();
+	}
+	/** Returns all nodes with given key
+	 * @param key - key to look for
+	 * @return Pointer to the group of nodes, nullptr if no node has this key
+	 */
+	const std::vector<listNode<T> *> *lookup(const Key &key) const
+	{
+		auto groupIt = nodesByKey.find(key);
+		return groupIt == nodesByKey.end() ? nullptr : &groupIt->second;
+	}
+};
+
+template <class T, class Key, class Projection>
+/**Hash index with key computed by a projection (callable or pointer to member)*/
+class listHashIndex : public listKeyIndex<T, Key>
+{
+private:
+	Projection projection; /**< Callable which computes key of an element*/
+
+public:
+	/** Index constructor
+	 * @param _projection - callable which computes key of an element
+	 */
+	listHashIndex(Projection _projection) : projection(_projection) {}
+	Key keyOf(T &elem) override { return std::invoke(projection, elem); }
+	std::unique_ptr<listIndex<T>> cloneEmpty() const override
+	{
+		return std::unique_ptr<listIndex<T>>(new listHashIndex<T, Key, Projection>(projection));
+	}
+};
+
+/**Projection used by an index keyed on the whole element*/
+struct identityKey
+{
+	/** Returns the element itself
+	 * @param elem - element stored in the list
+	 * @return The same element
+	 */
+	template <class U>
+	U &operator()(U &elem) const { return elem; }
+};
+
+/**Tie-breaking comparator used by sort_by() by default, elements with equal keys keep their order*/
+struct keepOrder
+{
+	/** Never puts one element before another
+	 * @return Always false
+	 */
+	template <class U>
+	bool operator()(U &, U &) const { return false; }
+};
+
+/**Tells whether sort_by() can order keys of given type by radix sort (integral and enum types up to 64 bits)*/
+template <class Key>
+constexpr bool radixSortable = (std::is_integral<Key>::value || std::is_enum<Key>::value) && sizeof(Key) <= sizeof(uint64_t);
+
 template <class T>
 /**Class used as list*/
 class list
 {
 private:
-	std::shared_ptr<listNode<T>> head; /**< Head of the list, points to the first element*/
-	std::shared_ptr<listNode<T>> tail; /**< Tail of the list, points to the last element*/
-	size_t size = 0;				   /**< Size of the list*/
+	listNode<T> *head; /**< Head of the list, points to the first element*/
+	listNode<T> *tail; /**< Tail of the list, points to the last element*/
+	size_t size = 0;   /**< Size of the list*/
+	std::shared_ptr<nodePool<T>> pool; /**< Memory for the nodes, shared with lists this one exchanged nodes with*/
+	std::unique_ptr<listIndex<T>> index; /**< Optional secondary index, nullptr if disabled*/
+
+	static constexpr size_t parallelSortThreshold = 16384; /**< Minimal number of nodes per thread in parallel_sort()*/
+	static constexpr size_t parallelAlgorithmThreshold = 1024; /**< Minimal number of nodes per segment in parallel algorithms, when thread count is chosen automatically*/
+	static constexpr double compactThreshold = 0.05; /**< Default fragmentation above which compact() relays the nodes*/
+	static constexpr uint64_t radixCountingRange = 1 << 16; /**< Keys spanning less values than this are sorted by sort_by() in one counting pass*/
+
+	/** Takes memory from the pool and constructs unlinked node in it, data is constructed in place
+	 * @param args - arguments passed to the constructor of T
+	 * @return Pointer to the new node
+	 */
+	template <class... Args>
+	listNode<T> *createNode(Args &&...args)
+	{
+		void *memory = storage().allocate();
+		listNode<T> *node;
+		try
+		{
+			node = new (memory) listNode<T>(std::in_place, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			storage().deallocate(memory);
+			throw;
+		}
+		if (index)
+			index->insert(node);
+		return node;
+	}
+	/** Merges two sorted, nullptr terminated chains linked only by nextNodePtr.
+	 * Nodes from 'first' go before equal nodes from 'second'.
+	 * @param first - chain with the earlier elements
+	 * @param second - chain with the later elements
+	 * @param comp - comparator used for ordering
+	 * @return First node of the merged chain
+	 */
+	template <class Compare>
+	static listNode<T> *mergeChains(listNode<T> *first, listNode<T> *second, Compare &comp)
+	{
+		listNode<T> *result = nullptr;
+		listNode<T> **link = &result;
+		while (first != nullptr && second != nullptr)
+		{
+			if (comp(second->data, first->data))
+			{
+				*link = second;
+				second = second->nextNodePtr;
+			}
+			else
+			{
+				*link = first;
+				first = first->nextNodePtr;
+			}
+			link = &(*link)->nextNodePtr;
+		}
+		*link = first != nullptr ? first : second;
+		return result;
+	}
+	/** Sorts nullptr terminated chain linked only by nextNodePtr (stable bottom-up merge sort)
+	 * @param first - first node of the chain
+	 * @param comp - comparator used for ordering
+	 * @return First node of the sorted chain, previous pointers are not updated
+	 */
+	template <class Compare>
+	static listNode<T> *sortChain(listNode<T> *first, Compare &comp);
+	/** Sets previous pointers and tail after the chain starting at head was relinked using next pointers only*/
+	void restorePreviousLinks();
+	/** Converts integral key to unsigned number with the same ordering
+	 * @param key - the key
+	 * @return key as unsigned number, signed keys are shifted by 2^63
+	 */
+	template <class Key>
+	static uint64_t radixKey(Key key)
+	{
+		if constexpr (std::is_enum<Key>::value)
+			return radixKey(static_cast<std::underlying_type_t<Key>>(key));
+		else if constexpr (std::is_signed<Key>::value)
+			return static_cast<uint64_t>(static_cast<int64_t>(key)) ^ (uint64_t(1) << 63);
+		else
+			return static_cast<uint64_t>(key);
+	}
+	/** Sorts nodes by integral keys without comparing elements and relinks them in the new order.
+	 * Keys are computed once; if they span less than radixCountingRange values one counting pass is done,
+	 * otherwise LSD radix sort by bytes of (key - smallest key) is used, skipping bytes equal for all keys.
+	 * Both are stable, runs of equal keys are then sorted by tieBreak (unless it is keepOrder).
+	 * @param key - projection returning integral key
+	 * @param tieBreak - comparator used for elements with equal keys
+	 */
+	template <class Projection, class Compare>
+	void radixSortBy(Projection &key, Compare &tieBreak);
+	/** Returns the pool which owns nodes of the list, creates it on first use.
+	 * If the pool was merged into another one, the list switches to that one.
+	 * @return Reference to the pool
+	 */
+	nodePool<T> &storage()
+	{
+		if (!pool)
+			pool = std::make_shared<nodePool<T>>();
+		for (std::shared_ptr<nodePool<T>> next = pool->owner(); next; next = pool->owner())
+			pool = std::move(next);
+		return *pool;
+	}
+	/** Makes this list and the other one use the same pool, so that nodes can be moved between them
+	 * @param otherList - list whose nodes will be linked into this one
+	 */
+	void sharePool(list<T> &otherList)
+	{
+		nodePool<T> &mine = storage();
+		nodePool<T> &theirs = otherList.storage();
+		if (&mine == &theirs)
+			return;
+		mine.adopt(theirs);
+		otherList.pool = pool;
+	}
+	/** Tells whether nodes of the pool can be dropped together with the list
+	 * @return true if no other list (and no pool which merged into this one) uses the pool of this list
+	 */
+	bool ownsStorage()
+	{
+		if (!pool)
+			return false;
+		storage();
+		return pool.use_count() == 1;
+	}
+	/** Appends copies of all elements of the other list, used by the copy constructor and the copy assignment.
+	 * Trivially copyable elements of a list without index are copied into runs of adjacent nodes, each node is written once
+	 * with the element and its links. This is not a memcpy of the source nodes: their links would have to be rewritten
+	 * in a second pass, which measured slower than filling the nodes directly.
+	 * @param otherList - list to copy elements from
+	 */
+	void copyElements(const list<T> &otherList);
+	/** Unlinks chain of nodes from the list, the nodes are not destroyed
+	 * @param first - first node of the chain
+	 * @param last - last node of the chain
+	 */
+	void unlinkChain(listNode<T> *first, listNode<T> *last)
+	{
+		if (first->previousNodePtr != nullptr)
+			first->previousNodePtr->nextNodePtr = last->nextNodePtr;
+		else
+			head = last->nextNodePtr;
+		if (last->nextNodePtr != nullptr)
+			last->nextNodePtr->previousNodePtr = first->previousNodePtr;
+		else
+			tail = first->previousNodePtr;
+		first->previousNodePtr = nullptr;
+		last->nextNodePtr = nullptr;
+	}
+	/** Links chain of nodes into the list before given node
+	 * @param before - node before which the chain is linked, nullptr to link it at the end
+	 * @param first - first node of the chain
+	 * @param last - last node of the chain
+	 */
+	void linkChain(listNode<T> *before, listNode<T> *first, listNode<T> *last)
+	{
+		listNode<T> *after = before != nullptr ? before->previousNodePtr : tail;
+		first->previousNodePtr = after;
+		last->nextNodePtr = before;
+		if (after != nullptr)
+			after->nextNodePtr = first;
+		else
+			head = first;
+		if (before != nullptr)
+			before->previousNodePtr = last;
+		else
+			tail = last;
+	}
+	/** Destroys node and gives its memory back to the pool, the index is not updated
+	 * @param node - node to destroy, it has to be unlinked from the list
+	 */
+	void releaseNode(listNode<T> *node)
+	{
+		node->~listNode<T>();
+		storage().deallocate(node);
+	}
+	/** Removes node from the index, destroys it and gives its memory back to the pool
+	 * @param node - node to destroy, it has to be unlinked from the list
+	 */
+	void destroyNode(listNode<T> *node)
+	{
+		if (index)
+			index->erase(node);
+		releaseNode(node);
+	}
+	/** Moves data out of the node and destroys the node
+	 * @param node - node to destroy, it has to be unlinked from the list
+	 * @return Data which was stored in the node
+	 */
+	T extractNode(listNode<T> *node)
+	{
+		if (index)
+			index->erase(node);
+		T val = std::move(node->data);
+		releaseNode(node);
+		return val;
+	}
+
+	/** Chooses number of segments for a parallel algorithm
+	 * @param threadCount - requested number of segments, 0 means all threads of the pool, but at least parallelAlgorithmThreshold nodes per segment
+	 * @return Number of segments, from 1 to size (0 for an empty list)
+	 */
+	unsigned segmentCount(unsigned threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = listThreadPool::instance().getThreadCount();
+			if (threadCount > size / parallelAlgorithmThreshold)
+				threadCount = static_cast<unsigned>(size / parallelAlgorithmThreshold);
+			if (threadCount == 0)
+				threadCount = 1;
+		}
+		if (threadCount > size)
+			threadCount = static_cast<unsigned>(size);
+		return threadCount;
+	}
+	/** Splits the list into segments of equal length and runs a task for every segment on listThreadPool
+	 * @param threadCount - number of segments, returned by segmentCount()
+	 * @param task - callable taking index of the segment, its first node and its length
+	 */
+	template <class SegmentTask>
+	void runSegments(unsigned threadCount, SegmentTask task)
+	{
+		if (threadCount == 0)
+			return;
+		if (threadCount == 1)
+		{
+			task(0u, head, size);
+			return;
+		}
+		std::vector<listNode<T> *> segments(threadCount);
+		listNode<T> *pointrr = head;
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			segments[i] = pointrr;
+			for (size_t j = size / threadCount + (i < size % threadCount ? 1 : 0); j > 0; j--)
+				pointrr = pointrr->nextNodePtr;
+		}
+		listThreadPool::instance().run(threadCount, [&](unsigned i)
+									   { task(i, segments[i], size / threadCount + (i < size % threadCount ? 1 : 0)); });
+	}
 
 public:
 	/** Default list constructor, creates blank list*/
 	list();
-	/** Copy constructor, creates a copy of the other list*/
-	list(list<T> &otherList);
+	/** Creates blank list whose nodes are allocated from given memory resource, in slabs of many nodes.
+	 * With std::pmr::monotonic_buffer_resource releasing the nodes costs a handful of frees, whatever the size of the list.
+	 * Nodes can only be moved between lists using equal resources (a list created without one uses std::pmr::new_delete_resource()),
+	 * otherwise errorType::differentResource is thrown, also when this list is still empty.
+	 * @param resource - resource for the nodes, it has to outlive the list and every list it gave nodes to
+	 */
+	explicit list(std::pmr::memory_resource *resource);
+	/** Copy constructor, creates a copy of the other list (its nodes are allocated from the default resource)*/
+	list(const list<T> &otherList);
 	/** Move contructor*/
 	list(list<T> &&otherList);
 	/** Default list destructor*/
 	~list();
 	/** Method which allows to add element at the end of the list
-	 * @param elem - element to add
+	 * @param elem - element to add, it is copied into the node
+	 */
+	void push_back(const T &elem) { emplace_back(elem); }
+	/** Method which allows to add element at the end of the list
+	 * @param elem - element to add, it is moved into the node
 	 */
-	void push_back(T elem);
+	void push_back(T &&elem) { emplace_back(std::move(elem)); }
 	/** Method which allows to add element at the beginning of the list
-	 * @param elem - element to add
+	 * @param elem - element to add, it is copied into the node
+	 */
+	void push_front(const T &elem) { emplace_front(elem); }
+	/** Method which allows to add element at the beginning of the list
+	 * @param elem - element to add, it is moved into the node
+	 */
+	void push_front(T &&elem) { emplace_front(std::move(elem)); }
+	/** Constructs element in place at the end of the list
+	 * @param args - arguments passed to the constructor of T
+	 * @return Reference to the new element
+	 */
+	template <class... Args>
+	T &emplace_back(Args &&...args);
+	/** Constructs element in place at the beginning of the list
+	 * @param args - arguments passed to the constructor of T
+	 * @return Reference to the new element
 	 */
-	void push_front(T elem);
+	template <class... Args>
+	T &emplace_front(Args &&...args);
 	/** Returns contents of the last element in the list
 	 * @return Reference to the last element in the list
 	 */
@@ -131,6 +1142,18 @@ public:
 	 * @return Deleted element
 	 */
 	T pop_front();
+	/** Detaches the first 'count' elements in one step, the nodes are moved to the returned list, not destroyed.
+	 * Finding the cut costs O(min(count, size - count)), relinking is O(1).
+	 * @param count - number of elements to detach, from 0 to size
+	 * @return List holding the detached elements in their order, it shares the pool of this list (see splice())
+	 */
+	list<T> pop_front(size_t count);
+	/** Detaches the last 'count' elements in one step, the nodes are moved to the returned list, not destroyed.
+	 * Finding the cut costs O(min(count, size - count)), relinking is O(1).
+	 * @param count - number of elements to detach, from 0 to size
+	 * @return List holding the detached elements in their order, it shares the pool of this list (see splice())
+	 */
+	list<T> pop_back(size_t count);
 	/**Method which allows to pop element in a chosen position in the list
 	 * @param position - position of the element to pop
 	 */
@@ -140,13 +1163,73 @@ public:
 	/** Search for an element in the list
 	 * @param elem - the elements to search for
 	 */
-	void search(T elem);
-	/** Swaps two adjacent elements
-	 * @param first - the first element to swap
+	void search(T elem);
+	/** Sorts the elements in the list using operator< (stable merge sort, O(n log n))*/
+	void sort();
+	/** Sorts the elements in the list using given comparator. Nodes are relinked, elements are not copied.
+	 * Sort is stable - equal elements keep their relative order.
+	 * @param comp - callable returning true if the first argument should go before the second one
+	 */
+	template <class Compare>
+	void sort(Compare comp);
+	/** Sorts the elements in the list by the key extracted from each of them (stable).
+	 * Integral and enum keys are sorted by counting/radix sort in linear time, other keys are compared with operator<.
+	 * @param key - callable (or pointer to member, e.g. &person::getAge) returning the value used for ordering
+	 * @param tieBreak - comparator ordering elements with equal keys, by default they keep their relative order
+	 */
+	template <class Projection, class Compare = keepOrder>
+	void sort_by(Projection key, Compare tieBreak = Compare());
+	/** Sorts the elements in the list using operator< on all available cores*/
+	void parallel_sort();
+	/** Sorts the elements in the list on several threads. The chain is cut into one segment per thread,
+	 * segments are sorted concurrently and merged back by relinking nodes. Lists shorter than
+	 * parallelSortThreshold nodes per thread are sorted sequentially. Sort is stable.
+	 * @param comp - comparator, it is copied to every worker thread and must not throw
+	 * @param threadCount - number of threads to use, 0 means std::thread::hardware_concurrency()
+	 */
+	template <class Compare>
+	void parallel_sort(Compare comp, unsigned threadCount = 0);
+	/** Calls a function for every element on several threads. The list is split in one pass into
+	 * segments of equal length, one per thread, segments are processed on listThreadPool.
+	 * Lists shorter than parallelAlgorithmThreshold nodes per thread are processed by fewer threads.
+	 * @param f - callable taking T&, called concurrently for different elements
+	 * @param threadCount - number of segments, 0 means all threads of the pool
+	 */
+	template <class Function>
+	void parallel_for_each(Function f, unsigned threadCount = 0);
+	/** Creates list of results of a function called for every element, computed on several threads
+	 * @param f - callable taking T&, called concurrently for different elements
+	 * @param threadCount - number of segments, 0 means all threads of the pool
+	 * @return List of results, in the order of the elements
+	 */
+	template <class Function>
+	list<std::decay_t<std::invoke_result_t<Function &, T &>>> parallel_transform(Function f, unsigned threadCount = 0);
+	/** Combines all elements on several threads. Every thread combines its segment, partial results
+	 * are combined in the order of the segments, so 'combine' has to be associative, but does not have to be commutative.
+	 * @param init - initial value, combined with the partial results
+	 * @param combine - callable returning combination of its two arguments (U and T, or two U)
+	 * @param threadCount - number of segments, 0 means all threads of the pool
+	 * @return Combination of 'init' and all elements
+	 */
+	template <class U, class Combine>
+	U parallel_reduce(U init, Combine combine, unsigned threadCount = 0);
+	/** Transforms every element and combines the results on several threads
+	 * (e.g. sum of ages: parallel_transform_reduce(0, std::plus<int>(), &person::getAge))
+	 * @param init - initial value, combined with the partial results
+	 * @param combine - associative callable returning combination of two U
+	 * @param transform - callable (or pointer to member) taking T&, its result is converted to U
+	 * @param threadCount - number of segments, 0 means all threads of the pool
+	 * @return Combination of 'init' and the transformed elements
+	 */
+	template <class U, class Combine, class Transform>
+	U parallel_transform_reduce(U init, Combine combine, Transform transform, unsigned threadCount = 0);
+	/** Counts elements satisfying a predicate on several threads
+	 * @param pred - callable taking T&, returning true for the elements to count
+	 * @param threadCount - number of segments, 0 means all threads of the pool
+	 * @return Number of elements for which 'pred' returned true
 	 */
-	void swap(std::shared_ptr<listNode<T>> first);
-	/** Sorts the elements in the list (Bubble sort used)*/
-	void sort();
+	template <class Predicate>
+	size_t parallel_count_if(Predicate pred, unsigned threadCount = 0);
 	/** Returns the number of elements in the list
 	 * @return The number of elements in the list
 	 */
@@ -155,17 +1238,58 @@ public:
 	 * @param fileName The name of the file to save the list to
 	 */
 	void save(std::string fileName);
-	/** Opens a list from a specified file
+	/** Opens a list from a specified file. The file is memory mapped and every line is parsed
+	 * by listParser<T> straight into a new node, lines which cannot be parsed are skipped.
 	 * @param fileName The name of the file to open the list from
 	 */
 	void open(std::string fileName);
+	/** Saves the list as a binary snapshot in one sequential pass. Trivially copyable elements are written
+	 * as raw bytes, other ones as length-prefixed records produced by listSerializer<T>.
+	 * @param fileName The name of the file to save the list to (used as given)
+	 */
+	void save_binary(std::string fileName);
+	/** Opens a list from a binary snapshot written by save_binary(). Header and its checksum are verified,
+	 * memory for all nodes is reserved at once and the file is read in one pass through a memory mapping.
+	 * @param fileName The name of the file to open the list from
+	 */
+	void open_binary(std::string fileName);
+	/** Reserves memory for the given number of nodes, so that adding them does not allocate node by node
+	 * @param count - number of nodes about to be added
+	 */
+	void reserve(size_t count) { storage().reserve(count); }
+	/** Returns the memory resource the nodes are allocated from
+	 * @return Pointer to the resource, std::pmr::new_delete_resource() unless another one was given to the constructor
+	 */
+	std::pmr::memory_resource *get_memory_resource() { return storage().getResource(); }
+	/** Measures how scattered the nodes are, O(n)
+	 * @return Share of nodes whose next node does not directly follow them in memory, 0 for a compacted list, close to 1 for scattered one
+	 */
+	double fragmentation() const;
+	/** Moves all elements into new nodes lying next to each other in the order of the list, so that traversal reads memory sequentially.
+	 * If no other list shares the pool, the nodes are taken from a new pool and the old one is freed at once,
+	 * otherwise they are taken from the shared pool. Iterators and references to the elements are invalidated, the index is rebuilt.
+	 * Memory for all nodes is taken before any element is moved and elements which can throw when moved are copied,
+	 * so the list is left unchanged if an exception is thrown.
+	 * @param threshold - nothing is done if fragmentation() is not above it, 0 compacts every list which is not compacted
+	 * @return true if the nodes were relaid
+	 */
+	bool compact(double threshold = compactThreshold);
+	/** Runs compact() on a separate thread, the list must not be used until the result is ready
+	 * @param threshold - nothing is done if fragmentation() is not above it
+	 * @return Future holding the result of compact()
+	 */
+	std::future<bool> compact_async(double threshold = compactThreshold)
+	{
+		return std::async(std::launch::async, [this, threshold]
+						  { return compact(threshold); });
+	}
 	/** Clears the memory by removing all nodes from the list and resets the head and tail pointers*/
 	void clear();
 	/** Copy assignment operator
 	 * @param otherList - the list to copy the contents from
 	 * @return A reference to the current list with the copied contents
 	 */
-	list<T> operator=(list<T> otherList)
+	list<T> &operator=(const list<T> &otherList)
 	{
 		if (&otherList == this)
 		{
@@ -173,22 +1297,9 @@ public:
 		}
 		else
 		{
-			if (!empty())
-			{
-
-				while (head != nullptr)
-				{
-					pop_front();
-				}
-			}
-
-			std::shared_ptr<listNode<T>> pointrr(otherList.head);
-
-			while (pointrr != nullptr)
-			{
-				push_back(pointrr->data);
-				pointrr = pointrr->nextNodePtr;
-			}
+			clear();
+			index = otherList.index ? otherList.index->cloneEmpty() : nullptr;
+			copyElements(otherList);
 			return *this;
 		}
 	}
@@ -196,90 +1307,411 @@ public:
 	 * @param otherList - the list to move the contents from
 	 * @return A reference to the current list with the moved contents
 	 */
-	list<T> operator=(list<T> &&otherList) noexcept
+	list<T> &operator=(list<T> &&otherList) noexcept
 	{
 		if (this != &otherList)
 		{
 			clear();
-			head = std::move(otherList.head);
-			tail = std::move(otherList.tail);
-			otherList.clear();
+			pool = std::move(otherList.pool);
+			index = std::move(otherList.index);
+			head = otherList.head;
+			tail = otherList.tail;
+			size = otherList.size;
+			otherList.head = nullptr;
+			otherList.tail = nullptr;
+			otherList.size = 0;
 		}
 
 		return *this;
 	}
 
-	/** Forward iterator class, used to traverse the list and access the elements stored in it*/
-	class iterator
+	/** Bidirectional iterator class, used to traverse the list and access the elements stored in it.
+	 * It holds a raw pointer to the node and to the list (end() is a null node, the list is needed to decrement it),
+	 * so copying and moving it is plain pointer work.
+	 * @tparam Constant - true for const_iterator, which gives read-only access to the elements
+	 */
+	template <bool Constant>
+	class basicIterator
 	{
 	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Constant, const T *, T *>;
+		using reference = std::conditional_t<Constant, const T &, T &>;
+
+		/** Creates singular iterator, it can only be assigned to*/
+		basicIterator() : ptr(nullptr), owner(nullptr) {}
 		/** Constructor for an iterator object
-		 * @param p - pointer to the node that the iterator will point
+		 * @param p - pointer to the node that the iterator will point, nullptr for end()
+		 * @param _owner - list the node belongs to
 		 */
-		iterator(std::shared_ptr<listNode<T>> p) : ptr(p) {}
+		basicIterator(listNode<T> *p, std::conditional_t<Constant, const list<T>, list<T>> *_owner) : ptr(p), owner(_owner) {}
+		/** Converts iterator to const_iterator*/
+		template <bool OtherConstant, class = std::enable_if_t<Constant && !OtherConstant>>
+		basicIterator(const basicIterator<OtherConstant> &other) : ptr(other.ptr), owner(other.owner) {}
 		/** Dereference operator
 		 * @return Returns reference to the element stored in the node
 		 */
-		T &operator*() { return ptr->data; }
+		reference operator*() const { return ptr->data; }
+		/** Gives access to members of the element stored in the node*/
+		pointer operator->() const { return &ptr->data; }
 		/** Increment operator - iterator is moved to the next node in the list
 		 * @return reference to the next node
 		 */
-		iterator &operator++()
+		basicIterator &operator++()
 		{
 			ptr = ptr->nextNodePtr;
 			return *this;
 		}
+		/** Postfix increment operator
+		 * @return Iterator pointing to the node before the increment
+		 */
+		basicIterator operator++(int)
+		{
+			basicIterator previous = *this;
+			ptr = ptr->nextNodePtr;
+			return previous;
+		}
 		/**
-		 * Decrement operator - iterator is moved to the previous node in the list
+		 * Decrement operator - iterator is moved to the previous node in the list, end() is moved to the last node
 		 * @return reference to the previous node
 		 */
-		iterator &operator--()
+		basicIterator &operator--()
 		{
-			ptr = ptr->previousNodePtr;
+			ptr = ptr != nullptr ? ptr->previousNodePtr : owner->tail;
 			return *this;
 		}
+		/** Postfix decrement operator
+		 * @return Iterator pointing to the node before the decrement
+		 */
+		basicIterator operator--(int)
+		{
+			basicIterator previous = *this;
+			--*this;
+			return previous;
+		}
 		/** Equality operator
 		 * @param other - the other iterator to compare with
 		 * @return true if the iterators point to the same node, false otherwise
 		 */
-		bool operator==(const iterator &other) { return ptr == other.ptr; }
+		template <bool OtherConstant>
+		bool operator==(const basicIterator<OtherConstant> &other) const { return ptr == other.ptr; }
 		/** Inequality operator
 		 * @param other - the other iterator to compare with
 		 * @return true if the iterators point to the different node, false otherwise
 		 */
-		bool operator!=(const iterator &other) { return ptr != other.ptr; }
+		template <bool OtherConstant>
+		bool operator!=(const basicIterator<OtherConstant> &other) const { return ptr != other.ptr; }
 
 	private:
-		std::shared_ptr<listNode<T>> ptr; /**< A shared pointer to a listNode, used to traverse the list*/
+		listNode<T> *ptr;													 /**< A pointer to a listNode, used to traverse the list*/
+		std::conditional_t<Constant, const list<T>, list<T>> *owner; /**< List the node belongs to, used to decrement end()*/
+
+		template <bool>
+		friend class basicIterator;
+		friend class list<T>;
 	};
 
+	using iterator = basicIterator<false>;					   /**< Iterator giving access to the elements*/
+	using const_iterator = basicIterator<true>;				   /**< Iterator giving read-only access to the elements*/
+	using reverse_iterator = std::reverse_iterator<iterator>;			   /**< Iterator walking the list backwards*/
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>; /**< Read-only iterator walking the list backwards*/
+
 	/** Returns an iterator pointing to the first element of the list
 	 * @return Iterator pointing to the first element of the list
 	 */
-	iterator begin() { return iterator(head); }
-	/** Returns an iterator pointing to the end of the list
+	iterator begin() { return iterator(head, this); }
+	/** Returns an iterator pointing to the end of the list, it can be decremented to the last element
 	 * @return Iterator pointing to the end of the list
 	 */
-	iterator end() { return iterator(nullptr); }
+	iterator end() { return iterator(nullptr, this); }
+	/** Returns a read-only iterator pointing to the first element of the list*/
+	const_iterator begin() const { return const_iterator(head, this); }
+	/** Returns a read-only iterator pointing to the end of the list*/
+	const_iterator end() const { return const_iterator(nullptr, this); }
+	/** Returns a read-only iterator pointing to the first element of the list*/
+	const_iterator cbegin() const { return begin(); }
+	/** Returns a read-only iterator pointing to the end of the list*/
+	const_iterator cend() const { return end(); }
+	/** Returns a reverse iterator pointing to the last element of the list*/
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	/** Returns a reverse iterator pointing before the first element of the list*/
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	/** Returns a read-only reverse iterator pointing to the last element of the list*/
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	/** Returns a read-only reverse iterator pointing before the first element of the list*/
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+	/** Returns a read-only reverse iterator pointing to the last element of the list*/
+	const_reverse_iterator crbegin() const { return rbegin(); }
+	/** Returns a read-only reverse iterator pointing before the first element of the list*/
+	const_reverse_iterator crend() const { return rend(); }
+	/** Constructs element in place before given position
+	 * @param position - iterator to the element before which the new one is inserted, end() to add it at the end
+	 * @param args - arguments passed to the constructor of T
+	 * @return Iterator pointing to the new element
+	 */
+	template <class... Args>
+	iterator emplace(iterator position, Args &&...args);
+	/** Inserts copy of the element before given position, O(1)
+	 * @param position - iterator to the element before which the new one is inserted, end() to add it at the end
+	 * @param elem - element to add
+	 * @return Iterator pointing to the new element
+	 */
+	iterator insert(iterator position, const T &elem) { return emplace(position, elem); }
+	/** Moves element into the list before given position, O(1)
+	 * @param position - iterator to the element before which the new one is inserted, end() to add it at the end
+	 * @param elem - element to add
+	 * @return Iterator pointing to the new element
+	 */
+	iterator insert(iterator position, T &&elem) { return emplace(position, std::move(elem)); }
+	/** Removes element from the list, O(1)
+	 * @param position - iterator pointing to the element to remove
+	 * @return Iterator pointing to the element after the removed one
+	 */
+	iterator erase(iterator position);
+	/** Removes elements from the range [first, last), O(number of removed elements)
+	 * @param first - iterator pointing to the first element to remove
+	 * @param last - iterator pointing to the element after the last one to remove
+	 * @return last
+	 */
+	iterator erase(iterator first, iterator last);
+	/** Moves all elements of the other list before given position, no element is copied, O(1)
+	 *
+	 * Moving nodes merges the pools of both lists for good (also when just one element is moved, or the list is split or merged).
+	 * The shared pool locks itself from then on, so the lists can still be used from different threads,
+	 * but every single list still has to be used by one thread at a time. The lists have to use equal memory resources,
+	 * otherwise errorType::differentResource is thrown.
+	 * @param position - iterator to the element before which the elements are linked, end() to link them at the end
+	 * @param otherList - list to take the elements from, it is left empty
+	 */
+	void splice(iterator position, list<T> &otherList);
+	/** Moves one element of the other list before given position, O(1)
+	 * @param position - iterator to the element before which the element is linked, end() to link it at the end
+	 * @param otherList - list to take the element from (may be this list)
+	 * @param elem - iterator pointing to the element to move
+	 */
+	void splice(iterator position, list<T> &otherList, iterator elem);
+	/** Moves range [first, last) of the other list before given position, no element is copied or reallocated.
+	 * Nodes are relinked in O(1), counting them for the size of both lists costs O(length of the range).
+	 * @param position - iterator to the element before which the range is linked, it cannot be inside the range
+	 * @param otherList - list to take the elements from (may be this list)
+	 * @param first - iterator pointing to the first element of the range
+	 * @param last - iterator pointing to the element after the range
+	 */
+	void splice(iterator position, list<T> &otherList, iterator first, iterator last);
+	/** Adds copies of the elements of range [first, last) at the end of the list. Nodes are taken straight from the pool
+	 * (whole slabs at a time), chained first and linked into the list in one step, so if constructing an element
+	 * throws the list is left unchanged. Call reserve() before to get all nodes from one slab.
+	 * @param first - iterator pointing to the first element to add
+	 * @param last - iterator pointing to the element after the last one to add
+	 */
+	template <class InputIt>
+	void append(InputIt first, InputIt last);
+	/** Replaces contents of the list with copies of the elements of range [first, last)
+	 * @param first - iterator pointing to the first element, the range must not come from this list
+	 * @param last - iterator pointing to the element after the last one
+	 */
+	template <class InputIt>
+	void assign(InputIt first, InputIt last);
+	/** Merges the other sorted list into this sorted one using operator< by relinking nodes, O(n + m).
+	 * The lists share their pool afterwards, like after splice().
+	 * @param otherList - sorted list to take the elements from, it is left empty
+	 */
+	void merge(list<T> &otherList);
+	/** Merges the other sorted list into this sorted one by relinking nodes, O(n + m).
+	 * Merge is stable, of two equal elements the one from this list goes first.
+	 * @param otherList - list sorted by 'comp' to take the elements from, it is left empty
+	 * @param comp - callable returning true if the first argument should go before the second one
+	 */
+	template <class Compare>
+	void merge(list<T> &otherList, Compare comp);
+	/** Cuts the list in two, the elements from given position onwards are moved to the returned list.
+	 * Relinking is O(1); both lists keep their sizes, so the nodes of the shorter part are counted,
+	 * walking from the cut in both directions at once - O(min(k, n - k)).
+	 * @param position - iterator pointing to the first element of the second part, end() gives an empty list
+	 * @return List holding the elements [position, end()), it shares the pool of this list (see splice())
+	 */
+	list<T> split(iterator position);
+	/** Swaps two adjacent elements by relinking their nodes
+	 * @param first - iterator pointing to the first element to swap, the next element has to exist
+	 */
+	void swap(iterator first);
+
+private:
+	/** Moves chain of nodes from the other list before given position, updates sizes, indexes and pools
+	 * @param position - iterator to the element before which the chain is linked
+	 * @param otherList - list the chain belongs to (may be this list)
+	 * @param first - first node of the chain
+	 * @param last - last node of the chain
+	 * @param count - number of nodes in the chain, ignored when otherList is this list
+	 */
+	void transferNodes(iterator position, list<T> &otherList, listNode<T> *first, listNode<T> *last, size_t count);
+	/** Finds node at given position, walking from the closer end of the list
+	 * @param position - position from 0 to size
+	 * @return Pointer to the node, nullptr for position equal to size
+	 */
+	listNode<T> *nodeAt(size_t position)
+	{
+		if (position <= size / 2)
+		{
+			listNode<T> *pointrr = head;
+			for (; position > 0; position--)
+				pointrr = pointrr->nextNodePtr;
+			return pointrr;
+		}
+		listNode<T> *pointrr = nullptr;
+		for (size_t steps = size - position; steps > 0; steps--)
+			pointrr = pointrr != nullptr ? pointrr->previousNodePtr : tail;
+		return pointrr;
+	}
+	/** Moves the chain [first, last) of this list to a new list sharing the pool
+	 * @param first - first node of the chain
+	 * @param last - node after the chain, nullptr for the end of the list
+	 * @param count - number of nodes in the chain
+	 * @return List holding the chain
+	 */
+	list<T> detach(listNode<T> *first, listNode<T> *last, size_t count);
+
+public:
+
+	/** Turns on hash index keyed on the whole element (std::hash<T> has to exist).
+	 * The index is kept up to date by every insertion and removal, elements must not be modified
+	 * through references while it is on (call rebuild_index() after such changes).
+	 */
+	void enable_index() { enable_index(identityKey()); }
+	/** Turns on hash index keyed on a projection of the element, replaces previous index
+	 * @param key - callable or pointer to member (e.g. &person::getName) computing the key, std::hash has to exist for its type
+	 */
+	template <class Projection>
+	void enable_index(Projection key);
+	/** Turns off the index and frees its memory*/
+	void disable_index() { index.reset(); }
+	/** Fills the index again from the current contents of the list*/
+	void rebuild_index();
+	/** Finds first element equal to elem, uses index keyed on the whole element if enabled, O(n) scan otherwise.
+	 * With the index the result is the same, if there are many equal elements the list is walked up to the first of them.
+	 * @param elem - element to look for
+	 * @return Iterator to the found element, end() if there is none
+	 */
+	iterator find(const T &elem);
+	/** Finds all elements equal to elem, uses index keyed on the whole element if enabled, O(n) scan otherwise
+	 * @param elem - element to look for
+	 * @return List of iterators to the found elements
+	 */
+	list<iterator> find_all(const T &elem);
+	/** Finds first element with given key of the index, O(1) average if only one element has the key,
+	 * otherwise the list is walked up to the first of them
+	 * @param key - key to look for, it has to have the same type as the key of the index (string literals are looked up as std::string)
+	 * @return Iterator to the first element with this key in the list order, end() if there is none
+	 */
+	template <class Key>
+	iterator find_by(const Key &key);
+	/** Finds all elements with given key of the index, O(1) average plus number of found elements
+	 * @param key - key to look for, it has to have the same type as the key of the index (string literals are looked up as std::string)
+	 * @return List of iterators to the found elements, in no particular order
+	 */
+	template <class Key>
+	list<iterator> find_all_by(const Key &key);
+
+private:
+	static constexpr bool hashableElements = std::is_default_constructible<std::hash<T>>::value; /**< true if std::hash<T> exists*/
+
+	/** Returns the index if it is keyed on the whole element, may be used only if hashableElements is true
+	 * @return Pointer to the index, nullptr if there is no such index
+	 */
+	listKeyIndex<T, T> *identityIndex() { return dynamic_cast<listHashIndex<T, T, identityKey> *>(index.get()); }
+	/** Returns the index with given key type
+	 * @return Pointer to the index, throws if there is no index with this key type
+	 */
+	template <class Key>
+	listKeyIndex<T, Key> *keyIndex()
+	{
+		listKeyIndex<T, Key> *keyed = dynamic_cast<listKeyIndex<T, Key> *>(index.get());
+		if (keyed == nullptr)
+			throw myException(errorType::noIndex);
+		return keyed;
+	}
+	/** Picks the node which comes first in the list from a group found in the index
+	 * @param group - nodes with equal keys, may be nullptr
+	 * @return The first node of the group in the list order, nullptr if the group is empty
+	 */
+	listNode<T> *firstInList(const std::vector<listNode<T> *> *group) const;
+};
+
+/**Type of the key looked up by list<T>::find_by()/find_all_by() for an argument of type Key:
+ * the decayed type, with character pointers and arrays (string literals) replaced by std::string
+ */
+template <class Key>
+using listLookupKey = std::conditional_t<std::is_same<std::decay_t<Key>, const char *>::value || std::is_same<std::decay_t<Key>, char *>::value,
+										 std::string, std::decay_t<Key>>;
+
+/**Name kept once in 'nameTable', people with the same name point to the same entry*/
+struct internedName
+{
+	std::string text;			/**< The name*/
+	std::atomic<uint64_t> rank; /**< Position of the name in alphabetical order, lower rank means earlier name*/
+
+	/** Creates entry with given text, the rank is assigned by the table
+	 * @param _text - the name
+	 */
+	internedName(std::string_view _text) : text(_text), rank(0) {}
+};
+
+/**Symbol table of names shared by the whole program. Entries are never freed, so pointers to them stay valid
+ * and two names are equal only if their entries are the same. Ranks keep alphabetical order of all names:
+ * a new name takes a rank in between the ranks of its neighbours and all ranks are reassigned only when there is
+ * no free rank left (names added in alphabetical order get ranks 2^32 apart, so it is rare).
+ * Interning is thread-safe, but comparing ranks while new names are interned in another thread may see
+ * ranks from before and after reassignment.
+ */
+class nameTable
+{
+private:
+	std::deque<internedName> entries;						 /**< All names, deque keeps their addresses*/
+	std::unordered_map<std::string_view, internedName *> lookup; /**< Names by text*/
+	std::map<std::string_view, internedName *> ordered;		 /**< Names in alphabetical order, used to assign ranks*/
+	std::mutex lock;										 /**< Mutex guarding the table*/
+
+	static constexpr uint64_t rankStep = uint64_t(1) << 32; /**< Distance between ranks of names added at either end*/
+
+	/** Gives all names ranks evenly spread over the whole range*/
+	void reassignRanks();
+
+public:
+	/** Returns table shared by the whole program
+	 * @return Reference to the table
+	 */
+	static nameTable &instance();
+	/** Finds entry of given name, adds it if the name is new
+	 * @param text - the name
+	 * @return Pointer to the entry, valid until the end of the program
+	 */
+	const internedName *intern(std::string_view text);
+	/** Returns number of different names in the table
+	 * @return Number of names
+	 */
+	size_t getSize();
 };
 
-/*Sample class, used for list class testing*/
+/*Sample class, used for list class testing. Names are interned in 'nameTable', so a person takes 16 bytes,
+ *comparing names is comparing pointers and ordering uses ranks of the names instead of comparing strings.*/
 class person
 {
 public:
 	/** Default person constructor*/
-	person() : name("Jan"), age(32){};
+	person() : name(defaultName()), age(32){};
 	/** Person constructor, assigns name and age to the person
 	 * @param _name The name to assign to the person
 	 * @param _age The age to assign to the person
 	 */
-	person(std::string _name, int _age) : name(_name), age(_age){};
+	person(std::string_view _name, int _age) : name(nameTable::instance().intern(_name)), age(_age){};
 	/** Default person destructor*/
 	~person() = default;
 	/** Method which allows to change the name
 	 * @param _name - new name to assign to the person
 	 */
-	void setName(std::string _name);
+	void setName(std::string_view _name);
 	/** Method to get the name of the person
 	 * @return Name of the person
 	 */
@@ -302,14 +1734,19 @@ public:
 	}
 	/** "Lower than" operator
 	 * @param other - the person to compare to
-	 * @return true if this person's age is less than the other person's age, false otherwise
+	 * @return true if this person's age is less than the other person's age (or ages are equal and the name goes earlier in alphabetical order), false otherwise
 	 */
-	bool operator<(const person &other);
+	bool operator<(const person &other) const
+	{
+		if (age != other.age)
+			return age < other.age;
+		return name != other.name && name->rank.load(std::memory_order_relaxed) < other.name->rank.load(std::memory_order_relaxed);
+	}
 	/** "Greater than" operator
 	 * @param other - the person to compare to
-	 * @return true if this person's age is greater than the other person's age, false otherwise
+	 * @return true if this person's age is greater than the other person's age (or ages are equal and the name goes later in alphabetical order), false otherwise
 	 */
-	bool operator>(const person &other);
+	bool operator>(const person &other) const { return other < *this; }
 
 	/** Output stream operator
 	 * @param s - output stream
@@ -325,85 +1762,487 @@ public:
 	 */
 	friend std::istream &operator>>(std::istream &in, person &_person);
 
-private:
-	std::string name; /**< Name of the person*/
-	int age;		  /**< Person's age*/
-};
+	friend struct listSerializer<person>;
+
+private:
+	/** Returns entry of the default name
+	 * @return Entry of "Jan"
+	 */
+	static const internedName *defaultName();
+
+	const internedName *name; /**< Name of the person, entry in 'nameTable'*/
+	int age;				  /**< Person's age*/
+};
+
+template <>
+/**Parser for people, reads name and age separated by blanks (the format written by operator<<)*/
+struct listParser<person>
+{
+	/** Parses one line holding a person
+	 * @param line - contents of the line
+	 * @param elem - person to fill
+	 * @return true if the line held both name and age
+	 */
+	static bool parse(std::string_view line, person &elem);
+};
+
+template <>
+/**People hold pointers to interned names, so they are never written as raw bytes*/
+struct listRawRecords<person> : std::false_type
+{
+};
+
+template <>
+/**Serializer for people, the payload is the age (4 bytes) followed by the name*/
+struct listSerializer<person>
+{
+	/** Appends person to the buffer
+	 * @param buffer - output buffer
+	 * @param elem - person to write
+	 */
+	static void write(std::string &buffer, const person &elem);
+	/** Reads person
+	 * @param payload - bytes of the record
+	 * @param elem - person to fill
+	 * @return true if the payload was long enough
+	 */
+	static bool read(std::string_view payload, person &elem);
+};
+
+/**Function used in debugging, used just to put some space between outputs*/
+void gap();
+
+template <class T>
+list<T>::list() : head(nullptr), tail(nullptr) {}
+
+template <class T>
+list<T>::list(std::pmr::memory_resource *resource) : head(nullptr), tail(nullptr), pool(std::make_shared<nodePool<T>>(resource)) {}
+
+template <class T>
+list<T>::list(const list<T> &otherList) : head(nullptr), tail(nullptr)
+{
+	if (otherList.index)
+		index = otherList.index->cloneEmpty();
+	copyElements(otherList);
+}
+
+template <class T>
+list<T>::list(list<T> &&otherList) : head(otherList.head), tail(otherList.tail), size(otherList.size), pool(std::move(otherList.pool)), index(std::move(otherList.index))
+{
+	otherList.head = nullptr;
+	otherList.tail = nullptr;
+	otherList.size = 0;
+}
+
+template <class T>
+inline list<T>::~list()
+{
+	// Nodes which need no destructor are freed together with the pool
+	if constexpr (std::is_trivially_destructible<T>::value)
+	{
+		if (ownsStorage())
+			return;
+	}
+	clear();
+}
+
+template <class T>
+double list<T>::fragmentation() const
+{
+	if (size < 2)
+		return 0;
+	size_t scattered = 0;
+	for (listNode<T> *pointrr = head; pointrr->nextNodePtr != nullptr; pointrr = pointrr->nextNodePtr)
+	{
+		if (pointrr->nextNodePtr != pointrr + 1)
+			scattered++;
+	}
+	return static_cast<double>(scattered) / (size - 1);
+}
+
+template <class T>
+bool list<T>::compact(double threshold)
+{
+	if (size < 2 || fragmentation() <= threshold)
+		return false;
+
+	// A pool used only by this list is replaced, so its slabs are freed together instead of slot by slot
+	std::shared_ptr<nodePool<T>> target = ownsStorage() ? std::make_shared<nodePool<T>>(storage().getResource()) : pool;
+	// All memory is taken before any element is moved, so a failed allocation leaves the elements where they were
+	std::vector<std::pair<listNode<T> *, size_t>> runs;
+	try
+	{
+		for (size_t remaining = size; remaining > 0;)
+		{
+			size_t count = remaining;
+			runs.emplace_back(nullptr, 0);
+			runs.back().first = target->allocateRun(count);
+			runs.back().second = count;
+			remaining -= count;
+		}
+	}
+	catch (...)
+	{
+		for (const std::pair<listNode<T> *, size_t> &run : runs)
+		{
+			for (size_t i = 0; i < run.second; i++)
+				target->deallocate(run.first + i);
+		}
+		throw;
+	}
+
+	listNode<T> *chainHead = nullptr;
+	listNode<T> *chainTail = nullptr;
+	listNode<T> *pointrr = head;
+	try
+	{
+		for (const std::pair<listNode<T> *, size_t> &run : runs)
+		{
+			for (size_t i = 0; i < run.second; i++, pointrr = pointrr->nextNodePtr)
+			{
+				listNode<T> *node = new (run.first + i) listNode<T>(std::in_place, std::move_if_noexcept(pointrr->data));
+				node->previousNodePtr = chainTail;
+				if (chainTail != nullptr)
+					chainTail->nextNodePtr = node;
+				else
+					chainHead = node;
+				chainTail = node;
+			}
+		}
+	}
+	catch (...)
+	{
+		// Only copying can throw here (elements whose move can throw are copied), so the old nodes still hold every element
+		while (chainHead != nullptr)
+		{
+			listNode<T> *temp = chainHead;
+			chainHead = chainHead->nextNodePtr;
+			temp->~listNode<T>();
+		}
+		for (const std::pair<listNode<T> *, size_t> &run : runs)
+		{
+			for (size_t i = 0; i < run.second; i++)
+				target->deallocate(run.first + i);
+		}
+		throw;
+	}
+
+	// Old nodes of a replaced pool which need no destructor are freed with it
+	bool samePool = target == pool;
+	if (samePool || !std::is_trivially_destructible<T>::value)
+	{
+		pointrr = head;
+		while (pointrr != nullptr)
+		{
+			listNode<T> *temp = pointrr;
+			pointrr = pointrr->nextNodePtr;
+			temp->~listNode<T>();
+			if (samePool)
+				target->deallocate(temp);
+		}
+	}
+	head = chainHead;
+	tail = chainTail;
+	pool = std::move(target);
+	if (index)
+		rebuild_index();
+	return true;
+}
+
+template <class T>
+void list<T>::copyElements(const list<T> &otherList)
+{
+	if (otherList.head == nullptr)
+		return;
+	if constexpr (std::is_trivially_copyable<T>::value)
+	{
+		if (!index)
+		{
+			// Copying the element cannot throw (for trivially copyable T it is a plain byte copy), so the nodes are linked in one pass and need no rollback.
+			// They are taken from the pool in runs of adjacent slots, the chain joins the list at the end.
+			listNode<T> *chainHead = nullptr;
+			listNode<T> *chainTail = nullptr;
+			listNode<T> *pointrr = otherList.head;
+			for (size_t remaining = otherList.size; remaining > 0;)
+			{
+				size_t count = remaining;
+				listNode<T> *nodes = storage().allocateRun(count);
+				for (size_t i = 0; i < count; i++, pointrr = pointrr->nextNodePtr)
+				{
+					listNode<T> *node = new (nodes + i) listNode<T>(pointrr->data);
+					node->previousNodePtr = i == 0 ? chainTail : nodes + i - 1;
+					node->nextNodePtr = nodes + i + 1;
+				}
+				if (chainTail != nullptr)
+					chainTail->nextNodePtr = nodes;
+				else
+					chainHead = nodes;
+				chainTail = nodes + count - 1;
+				remaining -= count;
+			}
+			linkChain(nullptr, chainHead, chainTail);
+			size += otherList.size;
+			return;
+		}
+	}
+	append(otherList.begin(), otherList.end());
+}
+
+template <class T>
+template <class... Args>
+T &list<T>::emplace_back(Args &&...args)
+{
+	listNode<T> *tmp = createNode(std::forward<Args>(args)...);
+	if (tail == nullptr)
+	{
+		head = tmp;
+		tail = tmp;
+		(*tmp).previousNodePtr = nullptr;
+		(*tmp).nextNodePtr = nullptr;
+	}
+	else
+	{
+		(*tmp).previousNodePtr = tail;
+		(*tail).nextNodePtr = tmp;
+		tail = tmp;
+		tail->nextNodePtr = nullptr;
+	}
+	size++;
+	return tmp->data;
+}
+
+template <class T>
+template <class... Args>
+T &list<T>::emplace_front(Args &&...args)
+{
+	listNode<T> *tmp = createNode(std::forward<Args>(args)...);
+	if (tail == nullptr)
+	{
+		head = tmp;
+		tail = tmp;
+		(*tmp).previousNodePtr = nullptr;
+		(*tmp).nextNodePtr = nullptr;
+	}
+	else
+	{
+		(*tmp).nextNodePtr = head;
+		(*head).previousNodePtr = tmp;
+		head = tmp;
+		head->previousNodePtr = nullptr;
+	}
+	size++;
+	return tmp->data;
+}
+
+template <class T>
+template <class... Args>
+typename list<T>::iterator list<T>::emplace(iterator position, Args &&...args)
+{
+	if (position.ptr == nullptr)
+	{
+		emplace_back(std::forward<Args>(args)...);
+		return iterator(tail, this);
+	}
+	listNode<T> *tmp = createNode(std::forward<Args>(args)...);
+	tmp->nextNodePtr = position.ptr;
+	tmp->previousNodePtr = position.ptr->previousNodePtr;
+	if (tmp->previousNodePtr != nullptr)
+		tmp->previousNodePtr->nextNodePtr = tmp;
+	else
+		head = tmp;
+	position.ptr->previousNodePtr = tmp;
+	size++;
+	return iterator(tmp, this);
+}
+
+template <class T>
+typename list<T>::iterator list<T>::erase(iterator position)
+{
+	listNode<T> *node = position.ptr;
+	if (node == nullptr)
+		throw myException(errorType::outOfRange);
+	listNode<T> *next = node->nextNodePtr;
+	unlinkChain(node, node);
+	size--;
+	destroyNode(node);
+	return iterator(next, this);
+}
+
+template <class T>
+typename list<T>::iterator list<T>::erase(iterator first, iterator last)
+{
+	while (first != last)
+		first = erase(first);
+	return last;
+}
+
+template <class T>
+void list<T>::transferNodes(iterator position, list<T> &otherList, listNode<T> *first, listNode<T> *last, size_t count)
+{
+	if (&otherList != this)
+	{
+		// Pools are joined first, it throws if they use different resources
+		sharePool(otherList);
+		if (otherList.index || index)
+		{
+			for (listNode<T> *pointrr = first; pointrr != last->nextNodePtr; pointrr = pointrr->nextNodePtr)
+			{
+				if (otherList.index)
+					otherList.index->erase(pointrr);
+				if (index)
+					index->insert(pointrr);
+			}
+		}
+		otherList.size -= count;
+		size += count;
+	}
+	otherList.unlinkChain(first, last);
+	linkChain(position.ptr, first, last);
+}
+
+template <class T>
+void list<T>::splice(iterator position, list<T> &otherList)
+{
+	if (&otherList == this || otherList.head == nullptr)
+		return;
+	transferNodes(position, otherList, otherList.head, otherList.tail, otherList.size);
+}
 
-/**Function used in debugging, used just to put some space between outputs*/
-void gap();
+template <class T>
+void list<T>::splice(iterator position, list<T> &otherList, iterator elem)
+{
+	if (elem.ptr == nullptr || position == elem)
+		return;
+	transferNodes(position, otherList, elem.ptr, elem.ptr, 1);
+}
 
 template <class T>
-list<T>::list() : head(nullptr), tail(nullptr) {}
+void list<T>::splice(iterator position, list<T> &otherList, iterator first, iterator last)
+{
+	if (first == last || (&otherList == this && position == last))
+		return;
+	listNode<T> *lastNode = last.ptr != nullptr ? last.ptr->previousNodePtr : otherList.tail;
+	size_t count = 0;
+	if (&otherList != this)
+	{
+		for (listNode<T> *pointrr = first.ptr; pointrr != last.ptr; pointrr = pointrr->nextNodePtr)
+			count++;
+	}
+	transferNodes(position, otherList, first.ptr, lastNode, count);
+}
 
 template <class T>
-list<T>::list(list<T> &otherList)
+list<T> list<T>::detach(listNode<T> *first, listNode<T> *last, size_t count)
 {
-	std::shared_ptr<listNode<T>> pointrr(otherList.head);
+	list<T> detached;
+	if (count == 0)
+		return detached;
+	storage();
+	detached.pool = pool;
+	detached.transferNodes(detached.end(), *this, first, last != nullptr ? last->previousNodePtr : tail, count);
+	return detached;
+}
 
-	while (pointrr != nullptr)
+template <class T>
+template <class InputIt>
+void list<T>::append(InputIt first, InputIt last)
+{
+	if (first == last)
+		return;
+
+	// Nodes are chained by nextNodePtr first, the chain joins the list only when all of them exist
+	listNode<T> *chainHead = nullptr;
+	listNode<T> *chainTail = nullptr;
+	size_t count = 0;
+	nodePool<T> &memory = storage();
+	try
 	{
-		push_back(pointrr->data);
-		pointrr = pointrr->nextNodePtr;
+		for (; first != last; ++first, ++count)
+		{
+			void *slot = memory.allocate();
+			listNode<T> *node;
+			try
+			{
+				node = new (slot) listNode<T>(std::in_place, *first);
+			}
+			catch (...)
+			{
+				memory.deallocate(slot);
+				throw;
+			}
+			node->previousNodePtr = chainTail;
+			if (chainTail != nullptr)
+				chainTail->nextNodePtr = node;
+			else
+				chainHead = node;
+			chainTail = node;
+			if (index)
+				index->insert(node);
+		}
+	}
+	catch (...)
+	{
+		while (chainHead != nullptr)
+		{
+			listNode<T> *temp = chainHead;
+			chainHead = chainHead->nextNodePtr;
+			destroyNode(temp);
+		}
+		throw;
 	}
+	linkChain(nullptr, chainHead, chainTail);
+	size += count;
 }
 
 template <class T>
-list<T>::list(list<T> &&otherList)
+template <class InputIt>
+void list<T>::assign(InputIt first, InputIt last)
 {
-	head = std::move(otherList.head);
-	tail = std::move(otherList.tail);
-	otherList.clear();
+	clear();
+	append(first, last);
 }
 
 template <class T>
-inline list<T>::~list()
+void list<T>::merge(list<T> &otherList)
 {
-	clear();
+	merge(otherList, [](T &a, T &b)
+		  { return a < b; });
 }
 
 template <class T>
-void list<T>::push_back(T elem)
+template <class Compare>
+void list<T>::merge(list<T> &otherList, Compare comp)
 {
-	std::shared_ptr<listNode<T>> tmp(new listNode<T>);
-	(*tmp).data = elem;
-	if (tail == nullptr)
-	{
-		head = tmp;
-		tail = tmp;
-		(*tmp).previousNodePtr = nullptr;
-		(*tmp).nextNodePtr = nullptr;
-	}
-	else
-	{
-		(*tmp).previousNodePtr = tail;
-		(*tail).nextNodePtr = tmp;
-		tail = tmp;
-		tail->nextNodePtr = nullptr;
-	}
-	size++;
+	if (&otherList == this || otherList.head == nullptr)
+		return;
+	// The other list is spliced at the end, then both runs are merged by next pointers
+	listNode<T> *firstRunTail = tail;
+	splice(end(), otherList);
+	if (firstRunTail == nullptr)
+		return;
+	listNode<T> *secondRun = firstRunTail->nextNodePtr;
+	firstRunTail->nextNodePtr = nullptr;
+	head = mergeChains(head, secondRun, comp);
+	restorePreviousLinks();
 }
 
 template <class T>
-void list<T>::push_front(T elem)
+list<T> list<T>::split(iterator position)
 {
-	std::shared_ptr<listNode<T>> tmp(new listNode<T>);
-	(*tmp).data = elem;
-	if (tail == nullptr)
-	{
-		head = tmp;
-		tail = tmp;
-		(*tmp).previousNodePtr = nullptr;
-		(*tmp).nextNodePtr = nullptr;
-	}
-	else
+	if (position.ptr == nullptr)
+		return list<T>();
+	// Count the part which ends first, walking forward from the cut and backward from the node before it
+	listNode<T> *forward = position.ptr;
+	listNode<T> *backward = position.ptr->previousNodePtr;
+	size_t steps = 0;
+	while (forward != nullptr && backward != nullptr)
 	{
-		(*tmp).nextNodePtr = head;
-		(*head).previousNodePtr = tmp;
-		head = tmp;
-		head->previousNodePtr = nullptr;
+		forward = forward->nextNodePtr;
+		backward = backward->previousNodePtr;
+		steps++;
 	}
-	size++;
+	size_t count = forward == nullptr ? steps : size - steps;
+	return detach(position.ptr, nullptr, count);
 }
 
 template <class T>
@@ -433,15 +2272,14 @@ inline T list<T>::pop_back()
 {
 	if (tail == nullptr)
 		throw myException();
-	std::shared_ptr<listNode<T>> tmp(tail);
-	T val = tail->data;
+	listNode<T> *tmp = tail;
 	if (tmp->previousNodePtr != nullptr)
 		tmp->previousNodePtr->nextNodePtr = nullptr;
 	else
 		head = nullptr;
 	tail = (tmp->previousNodePtr);
-	tmp.reset();
-	return val;
+	size--;
+	return extractNode(tmp);
 }
 
 template <class T>
@@ -449,16 +2287,32 @@ inline T list<T>::pop_front()
 {
 	if (head == nullptr)
 		throw myException();
-	std::shared_ptr<listNode<T>> tmp(head);
-	// debug
-	T val = (*tmp).data;
+	listNode<T> *tmp = head;
 	if (tmp->nextNodePtr != nullptr)
 		tmp->nextNodePtr->previousNodePtr = nullptr;
 	else
 		tail = nullptr;
 	head = tmp->nextNodePtr;
-	tmp.reset();
-	return val;
+	size--;
+	return extractNode(tmp);
+}
+
+template <class T>
+inline list<T> list<T>::pop_front(size_t count)
+{
+	if (count > size)
+		throw myException(errorType::outOfRange);
+	listNode<T> *cut = nodeAt(count);
+	return detach(head, cut, count);
+}
+
+template <class T>
+inline list<T> list<T>::pop_back(size_t count)
+{
+	if (count > size)
+		throw myException(errorType::outOfRange);
+	listNode<T> *cut = nodeAt(size - count);
+	return detach(cut, nullptr, count);
 }
 
 template <class T>
@@ -480,7 +2334,7 @@ inline T list<T>::pop_specified_position(int position)
 	}
 	else
 	{
-		std::shared_ptr<listNode<T>> pointrr(head);
+		listNode<T> *pointrr = head;
 		int elemCounter = 0;
 		while (pointrr != nullptr)
 		{
@@ -488,9 +2342,8 @@ inline T list<T>::pop_specified_position(int position)
 			{
 				pointrr->previousNodePtr->nextNodePtr = pointrr->nextNodePtr;
 				pointrr->nextNodePtr->previousNodePtr = pointrr->previousNodePtr;
-				T val = pointrr->data;
-				pointrr.reset();
-				return val;
+				size--;
+				return extractNode(pointrr);
 			}
 			++elemCounter;
 			pointrr = pointrr->nextNodePtr;
@@ -508,7 +2361,7 @@ inline void list<T>::display()
 	}
 	else
 	{
-		std::shared_ptr<listNode<T>> pointrr(head);
+		listNode<T> *pointrr = head;
 
 		while (pointrr != nullptr)
 		{
@@ -521,7 +2374,7 @@ inline void list<T>::display()
 template <class T>
 inline void list<T>::search(T elem)
 {
-	std::shared_ptr<listNode<T>> pointrr(head);
+	listNode<T> *pointrr = head;
 	int elemCounter = 0;
 	bool elemFound = false;
 	while (pointrr != nullptr)
@@ -539,8 +2392,11 @@ inline void list<T>::search(T elem)
 }
 
 template <class T>
-inline void list<T>::swap(std::shared_ptr<listNode<T>> first)
+inline void list<T>::swap(iterator position)
 {
+	listNode<T> *first = position.ptr;
+	if (first == nullptr)
+		throw myException(errorType::notSwappable);
 	if (first->previousNodePtr == nullptr)
 	{
 		if (first->nextNodePtr == nullptr)
@@ -549,7 +2405,7 @@ inline void list<T>::swap(std::shared_ptr<listNode<T>> first)
 		}
 		else
 		{
-			std::shared_ptr<listNode<T>> second = first->nextNodePtr;
+			listNode<T> *second = first->nextNodePtr;
 			second->previousNodePtr = nullptr;
 			head = second;
 			first->previousNodePtr = second;
@@ -567,7 +2423,7 @@ inline void list<T>::swap(std::shared_ptr<listNode<T>> first)
 		}
 		else
 		{
-			std::shared_ptr<listNode<T>> second = first->nextNodePtr;
+			listNode<T> *second = first->nextNodePtr;
 			first->previousNodePtr->nextNodePtr = second;
 			second->previousNodePtr = first->previousNodePtr;
 			if (second->nextNodePtr != nullptr)
@@ -589,23 +2445,283 @@ inline void list<T>::swap(std::shared_ptr<listNode<T>> first)
 template <class T>
 inline void list<T>::sort()
 {
-	if ((head != nullptr) || (head != tail))
+	sort([](T &a, T &b)
+		 { return a < b; });
+}
+
+template <class T>
+template <class Compare>
+inline void list<T>::sort(Compare comp)
+{
+	if (head == tail)
+		return;
+
+	head = sortChain(head, comp);
+	restorePreviousLinks();
+}
+
+template <class T>
+template <class Compare>
+inline listNode<T> *list<T>::sortChain(listNode<T> *first, Compare &comp)
+{
+	// Bottom-up merge sort: bins[i] holds a sorted run of 2^i nodes, built like a binary counter.
+	// Higher bins always hold earlier elements, so they go first in every merge to keep the sort stable.
+	constexpr int binCount = 64;
+	listNode<T> *bins[binCount] = {};
+	listNode<T> *pointrr = first;
+	while (pointrr != nullptr)
 	{
-		for (int i = 0; i < size - 1; i++)
+		listNode<T> *run = pointrr;
+		pointrr = pointrr->nextNodePtr;
+		run->nextNodePtr = nullptr;
+		int i = 0;
+		for (; i < binCount - 1 && bins[i] != nullptr; ++i)
 		{
-			auto pointr1 = head;
-			auto pointr2 = pointr1->nextNodePtr;
-			while (pointr2 != nullptr)
-			{
-				if ((*pointr2).data < (*pointr1).data)
-					swap(pointr1);
-				pointr1 = pointr2;
-				pointr2 = pointr1->nextNodePtr;
-				// std::cout << "pointr1: " <<(*pointr1).data;
-				// std::cout << "\npointr2: " <<(*pointr2).data;
-			}
+			run = mergeChains(bins[i], run, comp);
+			bins[i] = nullptr;
+		}
+		bins[i] = mergeChains(bins[i], run, comp);
+	}
+
+	listNode<T> *result = nullptr;
+	for (int i = 0; i < binCount; ++i)
+	{
+		if (bins[i] != nullptr)
+			result = mergeChains(bins[i], result, comp);
+	}
+	return result;
+}
+
+template <class T>
+inline void list<T>::restorePreviousLinks()
+{
+	if (head == nullptr)
+	{
+		tail = nullptr;
+		return;
+	}
+	head->previousNodePtr = nullptr;
+	listNode<T> *pointrr = head;
+	for (; pointrr->nextNodePtr != nullptr; pointrr = pointrr->nextNodePtr)
+		pointrr->nextNodePtr->previousNodePtr = pointrr;
+	tail = pointrr;
+}
+
+template <class T>
+inline void list<T>::parallel_sort()
+{
+	parallel_sort([](T &a, T &b)
+				  { return a < b; });
+}
+
+template <class T>
+template <class Compare>
+inline void list<T>::parallel_sort(Compare comp, unsigned threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+	if (threadCount > size / parallelSortThreshold)
+		threadCount = static_cast<unsigned>(size / parallelSortThreshold);
+	if (threadCount <= 1)
+	{
+		sort(comp);
+		return;
+	}
+
+	// Cut the chain into threadCount segments of (almost) equal length
+	std::unique_ptr<listNode<T> *[]> segments(new listNode<T> *[threadCount]);
+	listNode<T> *pointrr = head;
+	for (unsigned i = 0; i < threadCount; i++)
+	{
+		segments[i] = pointrr;
+		size_t segmentSize = size / threadCount + (i < size % threadCount ? 1 : 0);
+		for (size_t j = 1; j < segmentSize; j++)
+			pointrr = pointrr->nextNodePtr;
+		listNode<T> *next = pointrr->nextNodePtr;
+		pointrr->nextNodePtr = nullptr;
+		pointrr = next;
+	}
+
+	// Every segment is sorted on its own thread, then neighbouring segments are merged
+	// pairwise (again in parallel) until one chain is left. Segments keep their order, so the result is stable.
+	std::unique_ptr<std::thread[]> workers(new std::thread[threadCount]);
+	for (unsigned i = 0; i < threadCount; i++)
+		workers[i] = std::thread([&segments, i, comp]() mutable
+								 { segments[i] = sortChain(segments[i], comp); });
+	for (unsigned i = 0; i < threadCount; i++)
+		workers[i].join();
+
+	for (unsigned step = 1; step < threadCount; step *= 2)
+	{
+		unsigned started = 0;
+		for (unsigned i = 0; i + step < threadCount; i += 2 * step)
+			workers[started++] = std::thread([&segments, i, step, comp]() mutable
+											 { segments[i] = mergeChains(segments[i], segments[i + step], comp); });
+		for (unsigned i = 0; i < started; i++)
+			workers[i].join();
+	}
+
+	head = segments[0];
+	restorePreviousLinks();
+}
+
+template <class T>
+template <class Function>
+inline void list<T>::parallel_for_each(Function f, unsigned threadCount)
+{
+	runSegments(segmentCount(threadCount), [&f](unsigned, listNode<T> *first, size_t count)
+				{
+					for (; count > 0; count--, first = first->nextNodePtr)
+						f(first->data); });
+}
+
+template <class T>
+template <class Function>
+inline list<std::decay_t<std::invoke_result_t<Function &, T &>>> list<T>::parallel_transform(Function f, unsigned threadCount)
+{
+	using result = std::decay_t<std::invoke_result_t<Function &, T &>>;
+	// Every segment is transformed into its own list, the lists are spliced together afterwards
+	std::vector<list<result>> parts(segmentCount(threadCount));
+	runSegments(static_cast<unsigned>(parts.size()), [&f, &parts](unsigned i, listNode<T> *first, size_t count)
+				{
+					for (; count > 0; count--, first = first->nextNodePtr)
+						parts[i].push_back(f(first->data)); });
+	list<result> transformed;
+	for (auto &part : parts)
+		transformed.splice(transformed.end(), part);
+	return transformed;
+}
+
+template <class T>
+template <class U, class Combine>
+inline U list<T>::parallel_reduce(U init, Combine combine, unsigned threadCount)
+{
+	return parallel_transform_reduce(std::move(init), combine, [](T &elem) -> T &
+									 { return elem; },
+									 threadCount);
+}
+
+template <class T>
+template <class U, class Combine, class Transform>
+inline U list<T>::parallel_transform_reduce(U init, Combine combine, Transform transform, unsigned threadCount)
+{
+	// Partial results are kept in optionals, so U does not need to be default constructible
+	std::vector<std::optional<U>> partials(segmentCount(threadCount));
+	runSegments(static_cast<unsigned>(partials.size()), [&](unsigned i, listNode<T> *first, size_t count)
+				{
+					U partial = std::invoke(transform, first->data);
+					for (first = first->nextNodePtr, count--; count > 0; count--, first = first->nextNodePtr)
+						partial = combine(std::move(partial), std::invoke(transform, first->data));
+					partials[i].emplace(std::move(partial)); });
+	for (auto &partial : partials)
+		if (partial)
+			init = combine(std::move(init), std::move(*partial));
+	return init;
+}
+
+template <class T>
+template <class Predicate>
+inline size_t list<T>::parallel_count_if(Predicate pred, unsigned threadCount)
+{
+	return parallel_transform_reduce(size_t(0), std::plus<size_t>(), [&pred](T &elem) -> size_t
+									 { return pred(elem) ? 1 : 0; },
+									 threadCount);
+}
+
+template <class T>
+template <class Projection, class Compare>
+inline void list<T>::sort_by(Projection key, Compare tieBreak)
+{
+	using keyType = std::decay_t<std::invoke_result_t<Projection &, T &>>;
+	if constexpr (radixSortable<keyType>)
+	{
+		radixSortBy(key, tieBreak);
+	}
+	else if constexpr (std::is_same<Compare, keepOrder>::value)
+	{
+		sort([&key](T &a, T &b)
+			 { return std::invoke(key, a) < std::invoke(key, b); });
+	}
+	else
+	{
+		sort([&key, &tieBreak](T &a, T &b)
+			 {
+				 keyType keyA = std::invoke(key, a);
+				 keyType keyB = std::invoke(key, b);
+				 return keyA < keyB || (!(keyB < keyA) && tieBreak(a, b)); });
+	}
+}
+
+template <class T>
+template <class Projection, class Compare>
+inline void list<T>::radixSortBy(Projection &key, Compare &tieBreak)
+{
+	if (head == tail)
+		return;
+
+	using item = std::pair<uint64_t, listNode<T> *>;
+	std::vector<item> items;
+	items.reserve(size);
+	uint64_t lowest = UINT64_MAX;
+	uint64_t highest = 0;
+	for (listNode<T> *pointrr = head; pointrr != nullptr; pointrr = pointrr->nextNodePtr)
+	{
+		uint64_t k = radixKey(std::invoke(key, pointrr->data));
+		lowest = std::min(lowest, k);
+		highest = std::max(highest, k);
+		items.emplace_back(k, pointrr);
+	}
+	uint64_t range = highest - lowest;
+
+	std::vector<item> buffer(items.size());
+	if (range < radixCountingRange)
+	{
+		std::vector<size_t> counts(static_cast<size_t>(range) + 2, 0);
+		for (const item &i : items)
+			counts[static_cast<size_t>(i.first - lowest) + 1]++;
+		for (size_t i = 1; i < counts.size(); i++)
+			counts[i] += counts[i - 1];
+		for (const item &i : items)
+			buffer[counts[static_cast<size_t>(i.first - lowest)]++] = i;
+		items.swap(buffer);
+	}
+	else
+	{
+		for (unsigned shift = 0; shift < 64 && (range >> shift) != 0; shift += 8)
+		{
+			size_t counts[257] = {};
+			for (const item &i : items)
+				counts[((i.first - lowest) >> shift & 0xff) + 1]++;
+			if (std::find(counts + 1, counts + 257, items.size()) != counts + 257)
+				continue;
+			for (size_t i = 1; i < 257; i++)
+				counts[i] += counts[i - 1];
+			for (const item &i : items)
+				buffer[counts[(i.first - lowest) >> shift & 0xff]++] = i;
+			items.swap(buffer);
+		}
+	}
+
+	if constexpr (!std::is_same<Compare, keepOrder>::value)
+	{
+		auto byTieBreak = [&tieBreak](const item &a, const item &b)
+		{ return tieBreak(a.second->data, b.second->data); };
+		for (auto first = items.begin(); first != items.end();)
+		{
+			auto last = first + 1;
+			while (last != items.end() && last->first == first->first)
+				++last;
+			if (last - first > 1)
+				std::stable_sort(first, last, byTieBreak);
+			first = last;
 		}
 	}
+
+	head = items.front().second;
+	for (size_t i = 1; i < items.size(); i++)
+		items[i - 1].second->nextNodePtr = items[i].second;
+	items.back().second->nextNodePtr = nullptr;
+	restorePreviousLinks();
 }
 
 template <class T>
@@ -615,11 +2731,11 @@ inline void list<T>::save(std::string fileName)
 	std::ofstream fileToSave(fileName);
 	if (fileToSave)
 	{
-		std::shared_ptr<listNode<T>> pointrr(head);
+		listNode<T> *pointrr = head;
 
 		while (pointrr != nullptr)
 		{
-			fileToSave << pointrr->data << std::endl;
+			fileToSave << pointrr->data << '\n';
 			pointrr = pointrr->nextNodePtr;
 		}
 	}
@@ -632,46 +2748,267 @@ inline void list<T>::save(std::string fileName)
 template <class T>
 inline void list<T>::open(std::string fileName)
 {
-	if (head == nullptr)
+	if (head != nullptr)
+		throw myException(errorType::nonEmptyList);
+
+	mappedFile file(fileName);
+	// Nodes are filled after they are created, so the index is rebuilt once at the end
+	std::unique_ptr<listIndex<T>> savedIndex = std::move(index);
+	try
+	{
+		file.forEachLine([this](std::string_view line)
+						 {
+			T &elem = emplace_back();
+			if (!listParser<T>::parse(line, elem))
+				pop_back(); });
+	}
+	catch (...)
 	{
-		T a;
-		std::ifstream openFile(fileName);
-		std::string line;
-		if (openFile)
+		clear();
+		index = std::move(savedIndex);
+		throw;
+	}
+	index = std::move(savedIndex);
+	rebuild_index();
+}
+
+template <class T>
+inline void list<T>::save_binary(std::string fileName)
+{
+	std::ofstream fileToSave(fileName, std::ios::binary);
+	if (!fileToSave)
+		throw myException(errorType::fileNotOpened);
+
+	constexpr bool raw = listRawRecords<T>::value;
+	snapshotHeader header = snapshotHeader::make(raw ? snapshotHeader::rawRecords : 0, size, raw ? sizeof(T) : 0);
+	fileToSave.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	// Records are collected in a buffer and written in big blocks
+	constexpr size_t blockSize = 1 << 20;
+	std::string buffer;
+	buffer.reserve(blockSize + 4096);
+	for (listNode<T> *pointrr = head; pointrr != nullptr; pointrr = pointrr->nextNodePtr)
+	{
+		if constexpr (raw)
 		{
-			while (std::getline(openFile, line))
-			{
-				std::istringstream ss(line);
-				ss >> a;
-				push_back(a);
-			}
+			buffer.append(reinterpret_cast<const char *>(&pointrr->data), sizeof(T));
 		}
 		else
 		{
-			throw myException(errorType::fileNotOpened);
+			size_t lengthAt = buffer.size();
+			buffer.append(sizeof(uint32_t), '\0');
+			listSerializer<T>::write(buffer, pointrr->data);
+			uint32_t length = static_cast<uint32_t>(buffer.size() - lengthAt - sizeof(uint32_t));
+			std::memcpy(&buffer[lengthAt], &length, sizeof(length));
+		}
+		if (buffer.size() >= blockSize)
+		{
+			fileToSave.write(buffer.data(), buffer.size());
+			buffer.clear();
 		}
 	}
-	else
-	{
+	fileToSave.write(buffer.data(), buffer.size());
+	if (!fileToSave)
+		throw myException(errorType::fileNotOpened);
+}
+
+template <class T>
+inline void list<T>::open_binary(std::string fileName)
+{
+	if (head != nullptr)
 		throw myException(errorType::nonEmptyList);
+
+	mappedFile file(fileName);
+	const char *pointrr = file.begin();
+	const char *fileEnd = file.end();
+	snapshotHeader header;
+	if (static_cast<size_t>(fileEnd - pointrr) < sizeof(header))
+		throw myException(errorType::invalidFormat);
+	std::memcpy(&header, pointrr, sizeof(header));
+	pointrr += sizeof(header);
+	constexpr bool raw = listRawRecords<T>::value;
+	if (!header.valid() || (header.flags == snapshotHeader::rawRecords) != raw || (raw && header.elementSize != sizeof(T)))
+		throw myException(errorType::invalidFormat);
+	// The checksum covers only the header, so the count is checked against the records the file can hold
+	// before memory is reserved for them (a raw record takes sizeof(T) bytes, other ones at least their length)
+	const uint64_t remaining = static_cast<uint64_t>(fileEnd - pointrr);
+	const uint64_t minRecordSize = raw ? sizeof(T) : sizeof(uint32_t);
+	if (header.count > remaining / minRecordSize)
+		throw myException(errorType::invalidFormat);
+	if (raw && remaining != header.count * sizeof(T))
+		throw myException(errorType::invalidFormat);
+
+	reserve(static_cast<size_t>(header.count));
+	// Nodes are filled after they are created, so the index is rebuilt once at the end
+	std::unique_ptr<listIndex<T>> savedIndex = std::move(index);
+	try
+	{
+		for (uint64_t i = 0; i < header.count; i++)
+		{
+			if constexpr (raw)
+			{
+				T &elem = emplace_back();
+				std::memcpy(&elem, pointrr, sizeof(T));
+				pointrr += sizeof(T);
+			}
+			else
+			{
+				uint32_t length;
+				if (static_cast<size_t>(fileEnd - pointrr) < sizeof(length))
+					throw myException(errorType::invalidFormat);
+				std::memcpy(&length, pointrr, sizeof(length));
+				pointrr += sizeof(length);
+				if (static_cast<size_t>(fileEnd - pointrr) < length)
+					throw myException(errorType::invalidFormat);
+				T &elem = emplace_back();
+				if (!listSerializer<T>::read(std::string_view(pointrr, length), elem))
+					throw myException(errorType::invalidFormat);
+				pointrr += length;
+			}
+		}
+		if (pointrr != fileEnd)
+			throw myException(errorType::invalidFormat);
 	}
+	catch (...)
+	{
+		clear();
+		index = std::move(savedIndex);
+		throw;
+	}
+	index = std::move(savedIndex);
+	rebuild_index();
 }
 
 template <class T>
 inline void list<T>::clear()
 {
+	// The index is emptied at once instead of node by node
+	if (index)
+		index->clear();
+	// Nodes which need no destructor are not visited when no other list uses the pool
+	if constexpr (std::is_trivially_destructible<T>::value)
+	{
+		if (head != nullptr && ownsStorage())
+		{
+			storage().reset();
+			head = nullptr;
+			tail = nullptr;
+			size = 0;
+			return;
+		}
+	}
 	while (head != nullptr)
 	{
-		std::shared_ptr<listNode<T>> temp = head;
+		listNode<T> *temp = head;
 		head = head->nextNodePtr;
-		temp->previousNodePtr.reset();
-		temp->nextNodePtr.reset();
+		releaseNode(temp);
 	}
 
-	tail.reset();
+	tail = nullptr;
 	size = 0;
 }
 
+template <class T>
+template <class Projection>
+inline void list<T>::enable_index(Projection key)
+{
+	using Key = std::decay_t<std::invoke_result_t<Projection &, T &>>;
+	index.reset(new listHashIndex<T, Key, Projection>(key));
+	rebuild_index();
+}
+
+template <class T>
+inline void list<T>::rebuild_index()
+{
+	if (!index)
+		return;
+	index->clear();
+	for (listNode<T> *pointrr = head; pointrr != nullptr; pointrr = pointrr->nextNodePtr)
+		index->insert(pointrr);
+}
+
+template <class T>
+inline typename list<T>::iterator list<T>::find(const T &elem)
+{
+	if constexpr (hashableElements)
+	{
+		if (listKeyIndex<T, T> *keyed = identityIndex())
+		{
+			return iterator(firstInList(keyed->lookup(elem)), this);
+		}
+	}
+	for (listNode<T> *pointrr = head; pointrr != nullptr; pointrr = pointrr->nextNodePtr)
+	{
+		if (pointrr->data == elem)
+			return iterator(pointrr, this);
+	}
+	return end();
+}
+
+template <class T>
+inline list<typename list<T>::iterator> list<T>::find_all(const T &elem)
+{
+	list<iterator> found;
+	if constexpr (hashableElements)
+	{
+		if (listKeyIndex<T, T> *keyed = identityIndex())
+		{
+			if (const std::vector<listNode<T> *> *group = keyed->lookup(elem))
+			{
+				for (listNode<T> *node : *group)
+					found.push_back(iterator(node, this));
+			}
+			return found;
+		}
+	}
+	for (listNode<T> *pointrr = head; pointrr != nullptr; pointrr = pointrr->nextNodePtr)
+	{
+		if (pointrr->data == elem)
+			found.push_back(iterator(pointrr, this));
+	}
+	return found;
+}
+
+template <class T>
+listNode<T> *list<T>::firstInList(const std::vector<listNode<T> *> *group) const
+{
+	if (group == nullptr || group->empty())
+		return nullptr;
+	if (group->size() == 1)
+		return group->front();
+	// The index keeps the nodes in insertion order, the list is walked until one of them is met
+	std::vector<listNode<T> *> members(*group);
+	std::sort(members.begin(), members.end(), std::less<listNode<T> *>());
+	for (listNode<T> *pointrr = head; pointrr != nullptr; pointrr = pointrr->nextNodePtr)
+	{
+		if (std::binary_search(members.begin(), members.end(), pointrr, std::less<listNode<T> *>()))
+			return pointrr;
+	}
+	return nullptr;
+}
+
+template <class T>
+template <class Key>
+inline typename list<T>::iterator list<T>::find_by(const Key &key)
+{
+	const listLookupKey<Key> &lookupKey = key;
+	return iterator(firstInList(keyIndex<listLookupKey<Key>>()->lookup(lookupKey)), this);
+}
+
+template <class T>
+template <class Key>
+inline list<typename list<T>::iterator> list<T>::find_all_by(const Key &key)
+{
+	list<iterator> found;
+	const listLookupKey<Key> &lookupKey = key;
+	if (const std::vector<listNode<T> *> *group = keyIndex<listLookupKey<Key>>()->lookup(lookupKey))
+	{
+		for (listNode<T> *node : *group)
+			found.push_back(iterator(node, this));
+	}
+	return found;
+}
+
 /** Function displays a menu of options to the user and allows to interact with it.
  *
  * The menu options include:
@@ -0,0 +1,392 @@
+/**
+ * @file indexed_list.h
+ * @brief Bidirectional list with an order-statistic index (indexable skip list)
+ *
+ */
+
+#pragma once
+
+#ifndef INDEXED_LIST_H
+#define INDEXED_LIST_H
+
+#include "functions.h"
+#include "skip_list.h"
+
+#include <cstdint>
+
+struct indexedListLink;
+/**Links of a single node of 'indexed_list' class, also used alone as the list sentinel*/
+using indexedListLinks = skipListLinks<indexedListLink>;
+
+/**Link on one level of the index of 'indexed_list' class*/
+struct indexedListLink
+{
+	indexedListLinks *next;		/**< Next node on this level, sentinel after the last one*/
+	indexedListLinks *previous; /**< Previous node on this level, sentinel before the first one*/
+	size_t width = 1;			/**< Number of level 0 steps from this node to 'next'*/
+};
+
+template <class T>
+/**Struct used to store data, node of 'indexed_list' class*/
+struct indexedListNode : indexedListLinks
+{
+	T data; /**< Data stored in node*/
+	/** Node constructor, links are left unset
+	 * @param elem - data to store in the node
+	 */
+	indexedListNode(const T &elem) : data(elem) {}
+};
+
+template <class T>
+/**Bidirectional list with positional access in O(log n).
+ *
+ * Level 0 links form an ordinary circular doubly linked list around a sentinel. Every node also takes
+ * part in a random number of higher levels (express lanes), each link remembers how many elements it skips,
+ * so a position can be found by walking down the levels like in a skip list.
+ * at(), insert_at() and pop_specified_position() are O(log n) expected. Operations at both ends never search,
+ * they only touch the last/first link of every level in use, which is bounded by maxLevel.
+ */
+class indexed_list : private skipListBase<indexedListLink, indexedListNode<T>>
+{
+private:
+	using base = skipListBase<indexedListLink, indexedListNode<T>>;
+	using link = indexedListLink;
+	using base::maxLevel;
+	using base::sentinel;
+	using base::sentinelLinks;
+	using base::levelCount;
+	using base::size;
+	using base::createNode;
+	using base::destroyNode;
+
+	/** Turns on new levels of the sentinel, so that a node of given level can be linked in
+	 * @param level - level of the node about to be inserted
+	 */
+	void raiseLevelCount(int level)
+	{
+		for (; levelCount < level; ++levelCount)
+			sentinelLinks[levelCount] = {&sentinel, &sentinel, size + 1};
+	}
+	/** Finds the last node before given position on every level
+	 * @param position - position to look for, from 0 to size
+	 * @param update - filled with the last node before 'position' on every level
+	 * @param positions - filled with positions of the nodes from 'update' (-1 for the sentinel)
+	 */
+	void findPredecessors(size_t position, indexedListLinks **update, long long *positions)
+	{
+		indexedListLinks *pointrr = &sentinel;
+		long long pos = -1;
+		for (int l = levelCount - 1; l >= 0; --l)
+		{
+			while (pointrr->links[l].next != &sentinel && pos + static_cast<long long>(pointrr->links[l].width) < static_cast<long long>(position))
+			{
+				pos += pointrr->links[l].width;
+				pointrr = pointrr->links[l].next;
+			}
+			update[l] = pointrr;
+			positions[l] = pos;
+		}
+	}
+	/** Links node in at given position
+	 * @param node - node to link in
+	 * @param position - position the node will have
+	 * @param update - last node before 'position' on every level
+	 * @param positions - positions of the nodes from 'update'
+	 */
+	void linkNode(indexedListLinks *node, size_t position, indexedListLinks **update, long long *positions)
+	{
+		long long pos = static_cast<long long>(position);
+		for (int l = 0; l < node->level; ++l)
+		{
+			link &before = update[l]->links[l];
+			node->links[l] = {before.next, update[l], static_cast<size_t>(positions[l] + static_cast<long long>(before.width) + 1 - pos)};
+			before.next->links[l].previous = node;
+			before.next = node;
+			before.width = static_cast<size_t>(pos - positions[l]);
+		}
+		for (int l = node->level; l < levelCount; ++l)
+			++update[l]->links[l].width;
+		++size;
+	}
+	/** Unlinks node from the list, node is not destroyed
+	 * @param node - node to unlink
+	 * @param update - last node before 'node' on every level
+	 */
+	void unlinkNode(indexedListLinks *node, indexedListLinks **update)
+	{
+		for (int l = 0; l < node->level; ++l)
+		{
+			link &before = update[l]->links[l];
+			before.next = node->links[l].next;
+			before.width += node->links[l].width - 1;
+			node->links[l].next->links[l].previous = update[l];
+		}
+		for (int l = node->level; l < levelCount; ++l)
+			--update[l]->links[l].width;
+		--size;
+	}
+	/** Finds node at given position
+	 * @param position - position of the node, it has to be lower than size
+	 * @return Pointer to the node
+	 */
+	indexedListLinks *nodeAt(size_t position)
+	{
+		indexedListLinks *pointrr = &sentinel;
+		long long pos = -1;
+		long long target = static_cast<long long>(position);
+		for (int l = levelCount - 1; l >= 0; --l)
+		{
+			while (pointrr->links[l].next != &sentinel && pos + static_cast<long long>(pointrr->links[l].width) <= target)
+			{
+				pos += pointrr->links[l].width;
+				pointrr = pointrr->links[l].next;
+			}
+			if (pos == target)
+				break;
+		}
+		return pointrr;
+	}
+	/** Unlinks and destroys node, returns its data
+	 * @param node - node to remove
+	 * @param update - last node before 'node' on every level
+	 * @return Data stored in the node
+	 */
+	T removeNode(indexedListLinks *node, indexedListLinks **update)
+	{
+		unlinkNode(node, update);
+		T val = std::move(static_cast<indexedListNode<T> *>(node)->data);
+		destroyNode(node);
+		return val;
+	}
+
+public:
+	/** Default list constructor, creates blank list*/
+	indexed_list() = default;
+	/** Copy constructor, creates a copy of the other list*/
+	indexed_list(const indexed_list<T> &otherList) : indexed_list()
+	{
+		for (indexedListLinks *pointrr = otherList.sentinel.links[0].next; pointrr != &otherList.sentinel; pointrr = pointrr->links[0].next)
+			push_back(static_cast<indexedListNode<T> *>(pointrr)->data);
+	}
+	/** Move constructor*/
+	indexed_list(indexed_list<T> &&otherList) noexcept : indexed_list() { *this = std::move(otherList); }
+	/** Copy assignment operator
+	 * @param otherList - the list to copy the contents from
+	 * @return A reference to the current list with the copied contents
+	 */
+	indexed_list<T> &operator=(const indexed_list<T> &otherList)
+	{
+		if (this != &otherList)
+		{
+			clear();
+			for (indexedListLinks *pointrr = otherList.sentinel.links[0].next; pointrr != &otherList.sentinel; pointrr = pointrr->links[0].next)
+				push_back(static_cast<indexedListNode<T> *>(pointrr)->data);
+		}
+		return *this;
+	}
+	/** Move assignment operator, the sentinel cannot move, so the nodes next to it are relinked
+	 * @param otherList - the list to move the contents from
+	 * @return A reference to the current list with the moved contents
+	 */
+	indexed_list<T> &operator=(indexed_list<T> &&otherList) noexcept
+	{
+		if (this != &otherList)
+		{
+			clear();
+			base::takeNodes(otherList);
+		}
+		return *this;
+	}
+
+	/** Method which allows to add element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(T elem)
+	{
+		indexedListLinks *node = createNode(elem);
+		raiseLevelCount(node->level);
+		indexedListLinks *update[maxLevel];
+		long long positions[maxLevel];
+		for (int l = 0; l < levelCount; ++l)
+		{
+			update[l] = sentinelLinks[l].previous;
+			positions[l] = static_cast<long long>(size) - static_cast<long long>(update[l]->links[l].width);
+		}
+		linkNode(node, size, update, positions);
+	}
+	/** Method which allows to add element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(T elem)
+	{
+		indexedListLinks *node = createNode(elem);
+		raiseLevelCount(node->level);
+		indexedListLinks *update[maxLevel];
+		long long positions[maxLevel];
+		for (int l = 0; l < levelCount; ++l)
+		{
+			update[l] = &sentinel;
+			positions[l] = -1;
+		}
+		linkNode(node, 0, update, positions);
+	}
+	/** Method which inserts element at given position, elements from that position onwards move one place further
+	 * @param position - position of the new element, from 0 to size
+	 * @param elem - element to add
+	 */
+	void insert_at(size_t position, T elem)
+	{
+		if (position > size)
+			throw myException(errorType::outOfRange);
+		indexedListLinks *node = createNode(elem);
+		raiseLevelCount(node->level);
+		indexedListLinks *update[maxLevel];
+		long long positions[maxLevel];
+		findPredecessors(position, update, positions);
+		linkNode(node, position, update, positions);
+	}
+	/** Returns contents of the last element in the list
+	 * @return Reference to the last element in the list
+	 */
+	T &back()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return static_cast<indexedListNode<T> *>(sentinelLinks[0].previous)->data;
+	}
+	/** Returns contents of the first element in the list
+	 * @return Reference to the first element in the list
+	 */
+	T &front()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return static_cast<indexedListNode<T> *>(sentinelLinks[0].next)->data;
+	}
+	/** Returns element at given position
+	 * @param position - position of the element
+	 * @return Reference to the element
+	 */
+	T &at(size_t position)
+	{
+		if (position >= size)
+			throw myException(errorType::outOfRange);
+		return static_cast<indexedListNode<T> *>(nodeAt(position))->data;
+	}
+	/** Checks if the container is empty
+	 * @return true if the container is empty, false otherwise
+	 */
+	bool empty() { return size == 0; }
+	/** Returns the number of elements in the list
+	 * @return The number of elements in the list
+	 */
+	size_t getSize() { return size; }
+	/** Deletes node at the end of the list and returns deleted element
+	 * @return Deleted element
+	 */
+	T pop_back()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		indexedListLinks *node = sentinelLinks[0].previous;
+		indexedListLinks *update[maxLevel];
+		for (int l = 0; l < levelCount; ++l)
+			update[l] = l < node->level ? node->links[l].previous : sentinelLinks[l].previous;
+		return removeNode(node, update);
+	}
+	/** Deletes node at the beginning of the list and returns deleted element
+	 * @return Deleted element
+	 */
+	T pop_front()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		indexedListLinks *node = sentinelLinks[0].next;
+		indexedListLinks *update[maxLevel];
+		for (int l = 0; l < levelCount; ++l)
+			update[l] = &sentinel;
+		return removeNode(node, update);
+	}
+	/** Method which allows to pop element in a chosen position in the list
+	 * @param position - position of the element to pop
+	 * @return Deleted element
+	 */
+	T pop_specified_position(int position)
+	{
+		if (position < 0 || static_cast<size_t>(position) >= size)
+			throw myException(errorType::outOfRange);
+		indexedListLinks *update[maxLevel];
+		long long positions[maxLevel];
+		findPredecessors(static_cast<size_t>(position), update, positions);
+		return removeNode(update[0]->links[0].next, update);
+	}
+	/** Method displays all elements of the list*/
+	void display()
+	{
+		if (size == 0)
+		{
+			std::cout << "\t/Empty list!/" << std::endl;
+		}
+		else
+		{
+			for (indexedListLinks *pointrr = sentinelLinks[0].next; pointrr != &sentinel; pointrr = pointrr->links[0].next)
+				std::cout << static_cast<indexedListNode<T> *>(pointrr)->data << std::endl;
+		}
+	}
+	/** Clears the memory by removing all nodes from the list*/
+	void clear() { base::destroyNodes(); }
+
+	/** Bidirectional iterator class, walks level 0 of the list*/
+	class iterator
+	{
+	public:
+		/** Constructor for an iterator object
+		 * @param p - pointer to the node that the iterator will point
+		 */
+		iterator(indexedListLinks *p) : ptr(p) {}
+		/** Dereference operator
+		 * @return Returns reference to the element stored in the node
+		 */
+		T &operator*() { return static_cast<indexedListNode<T> *>(ptr)->data; }
+		/** Increment operator - iterator is moved to the next node in the list
+		 * @return reference to the next node
+		 */
+		iterator &operator++()
+		{
+			ptr = ptr->links[0].next;
+			return *this;
+		}
+		/** Decrement operator - iterator is moved to the previous node in the list, end() can be decremented
+		 * @return reference to the previous node
+		 */
+		iterator &operator--()
+		{
+			ptr = ptr->links[0].previous;
+			return *this;
+		}
+		/** Equality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the same node, false otherwise
+		 */
+		bool operator==(const iterator &other) { return ptr == other.ptr; }
+		/** Inequality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the different node, false otherwise
+		 */
+		bool operator!=(const iterator &other) { return ptr != other.ptr; }
+
+	private:
+		indexedListLinks *ptr; /**< A pointer to the node, used to traverse the list*/
+	};
+
+	/** Returns an iterator pointing to the first element of the list
+	 * @return Iterator pointing to the first element of the list
+	 */
+	iterator begin() { return iterator(sentinelLinks[0].next); }
+	/** Returns an iterator pointing to the end of the list (the sentinel)
+	 * @return Iterator pointing to the end of the list
+	 */
+	iterator end() { return iterator(&sentinel); }
+};
+
+#endif /* INDEXED_LIST_H */
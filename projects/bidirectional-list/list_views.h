@@ -0,0 +1,518 @@
+/**
+ * @file list_views.h
+ * @brief Lazy views over list<T> - filter, transform, take, drop, reverse and zip
+ *
+ */
+
+#pragma once
+
+#ifndef LIST_VIEWS_H
+#define LIST_VIEWS_H
+
+#include "functions.h"
+
+#include <utility>
+
+template <class T>
+class listRange;
+template <class View, class Predicate>
+class filterView;
+template <class View, class Function>
+class transformView;
+template <class View>
+class takeView;
+template <class View>
+class dropView;
+template <class View>
+class reverseView;
+template <class View, class OtherView>
+class zipView;
+
+/**Iterator category of a view iterator: the category of the underlying iterator, but only input iterator
+ * if dereferencing gives a value instead of a reference (e.g. transform returning a new object)
+ */
+template <class Reference, class BaseCategory>
+using viewIteratorCategory = std::conditional_t<std::is_reference<Reference>::value, BaseCategory, std::input_iterator_tag>;
+
+template <class Derived>
+/**Base of all views, lets views be composed by chaining: view(people).filter(adult).transform(&person::getAge).take(10).
+ * Views do not own elements and do not allocate, every element is computed when an iterator reaches it,
+ * so a chain of views is evaluated in one pass. Views hold the views they are built on by value and
+ * refer to the list, which has to outlive them and must not be modified while they are iterated.
+ */
+class listView
+{
+private:
+	/** Returns the view as its real type*/
+	const Derived &self() const { return static_cast<const Derived &>(*this); }
+
+public:
+	/** Creates view of the elements satisfying a predicate
+	 * @param pred - callable taking an element, returning true for the elements to keep
+	 * @return New view
+	 */
+	template <class Predicate>
+	filterView<Derived, Predicate> filter(Predicate pred) const { return filterView<Derived, Predicate>(self(), pred); }
+	/** Creates view of results of a function called for every element
+	 * @param f - callable (or pointer to member) taking an element
+	 * @return New view
+	 */
+	template <class Function>
+	transformView<Derived, Function> transform(Function f) const { return transformView<Derived, Function>(self(), f); }
+	/** Creates view of at most 'count' first elements
+	 * @param count - number of elements
+	 * @return New view
+	 */
+	takeView<Derived> take(size_t count) const { return takeView<Derived>(self(), count); }
+	/** Creates view without 'count' first elements
+	 * @param count - number of elements to skip
+	 * @return New view
+	 */
+	dropView<Derived> drop(size_t count) const { return dropView<Derived>(self(), count); }
+	/** Creates view of the elements in reverse order
+	 * @return New view
+	 */
+	reverseView<Derived> reverse() const { return reverseView<Derived>(self()); }
+	/** Creates view of pairs of elements of this view and the other one, it ends with the shorter one
+	 * @param other - the other view
+	 * @return New view
+	 */
+	template <class OtherView>
+	zipView<Derived, OtherView> zip(const listView<OtherView> &other) const
+	{
+		return zipView<Derived, OtherView>(self(), static_cast<const OtherView &>(other));
+	}
+	/** Creates view of pairs of elements of this view and the list, it ends with the shorter one
+	 * @param other - the list
+	 * @return New view
+	 */
+	template <class U>
+	zipView<Derived, listRange<U>> zip(list<U> &other) const { return zipView<Derived, listRange<U>>(self(), listRange<U>(other)); }
+	/** Copies elements of the view into a new list
+	 * @return List holding the elements
+	 */
+	auto to_list() const
+	{
+		list<typename Derived::iterator::value_type> result;
+		for (auto it = self().begin(), last = self().end(); it != last; ++it)
+			result.push_back(*it);
+		return result;
+	}
+	/** Counts elements of the view
+	 * @return Number of elements, O(n)
+	 */
+	size_t count() const
+	{
+		size_t n = 0;
+		for (auto it = self().begin(), last = self().end(); it != last; ++it)
+			n++;
+		return n;
+	}
+};
+
+template <class T>
+/**View of a whole list, the start of every chain of views*/
+class listRange : public listView<listRange<T>>
+{
+private:
+	list<T> *owner; /**< Viewed list*/
+
+public:
+	using iterator = typename list<T>::iterator; /**< Bidirectional iterator of the list, end() can be decremented*/
+
+	/** Creates view of the list
+	 * @param _owner - list to view
+	 */
+	explicit listRange(list<T> &_owner) : owner(&_owner) {}
+	/** Returns iterator to the first element*/
+	iterator begin() const { return owner->begin(); }
+	/** Returns iterator past the last element*/
+	iterator end() const { return owner->end(); }
+};
+
+/** Creates view of a list, the start of a chain of views
+ * @param l - list to view, it has to outlive the view
+ * @return View of the whole list
+ */
+template <class T>
+listRange<T> view(list<T> &l) { return listRange<T>(l); }
+
+template <class View, class Predicate>
+/**View of the elements satisfying a predicate, elements are tested while iterating*/
+class filterView : public listView<filterView<View, Predicate>>
+{
+private:
+	using baseIterator = decltype(std::declval<const View &>().begin());
+
+	View base;				/**< Underlying view*/
+	mutable Predicate pred; /**< Predicate choosing the elements*/
+
+public:
+	/** Iterator skipping elements which do not satisfy the predicate*/
+	class iterator
+	{
+	public:
+		using iterator_category = typename std::iterator_traits<baseIterator>::iterator_category;
+		using value_type = typename std::iterator_traits<baseIterator>::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = typename std::iterator_traits<baseIterator>::pointer;
+		using reference = typename std::iterator_traits<baseIterator>::reference;
+
+		/** Constructor for an iterator object
+		 * @param _current - position in the underlying view
+		 * @param _owner - the view
+		 */
+		iterator(baseIterator _current, const filterView *_owner) : current(_current), owner(_owner) {}
+		/** Dereference operator*/
+		reference operator*() const { return *current; }
+		/** Moves the iterator to the next element satisfying the predicate
+		 * @return Reference to the iterator
+		 */
+		iterator &operator++()
+		{
+			baseIterator last = owner->base.end();
+			do
+				++current;
+			while (current != last && !std::invoke(owner->pred, *current));
+			return *this;
+		}
+		/** Moves the iterator to the previous element satisfying the predicate, there has to be one
+		 * @return Reference to the iterator
+		 */
+		iterator &operator--()
+		{
+			do
+				--current;
+			while (!std::invoke(owner->pred, *current));
+			return *this;
+		}
+		/** Equality operator*/
+		bool operator==(const iterator &other) const { return current == other.current; }
+		/** Inequality operator*/
+		bool operator!=(const iterator &other) const { return !(current == other.current); }
+
+	private:
+		baseIterator current;	 /**< Position in the underlying view*/
+		const filterView *owner; /**< The view*/
+	};
+
+	/** Creates view
+	 * @param _base - underlying view
+	 * @param _pred - predicate choosing the elements
+	 */
+	filterView(const View &_base, Predicate _pred) : base(_base), pred(_pred) {}
+	/** Returns iterator to the first element satisfying the predicate, O(number of skipped elements)*/
+	iterator begin() const
+	{
+		baseIterator current = base.begin();
+		baseIterator last = base.end();
+		while (current != last && !std::invoke(pred, *current))
+			++current;
+		return iterator(current, this);
+	}
+	/** Returns iterator past the last element*/
+	iterator end() const { return iterator(base.end(), this); }
+};
+
+template <class View, class Function>
+/**View of results of a function called for every element, the function is called on every dereference*/
+class transformView : public listView<transformView<View, Function>>
+{
+private:
+	using baseIterator = decltype(std::declval<const View &>().begin());
+	using baseReference = typename std::iterator_traits<baseIterator>::reference;
+
+	View base;			/**< Underlying view*/
+	mutable Function f; /**< Function applied to the elements*/
+
+public:
+	/** Iterator giving results of the function*/
+	class iterator
+	{
+	public:
+		using reference = std::invoke_result_t<Function &, baseReference>;
+		using iterator_category = viewIteratorCategory<reference, typename std::iterator_traits<baseIterator>::iterator_category>;
+		using value_type = std::decay_t<reference>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::add_pointer_t<reference>;
+
+		/** Constructor for an iterator object
+		 * @param _current - position in the underlying view
+		 * @param _owner - the view
+		 */
+		iterator(baseIterator _current, const transformView *_owner) : current(_current), owner(_owner) {}
+		/** Dereference operator
+		 * @return Result of the function for the element
+		 */
+		reference operator*() const { return std::invoke(owner->f, *current); }
+		/** Moves the iterator to the next element*/
+		iterator &operator++()
+		{
+			++current;
+			return *this;
+		}
+		/** Moves the iterator to the previous element*/
+		iterator &operator--()
+		{
+			--current;
+			return *this;
+		}
+		/** Equality operator*/
+		bool operator==(const iterator &other) const { return current == other.current; }
+		/** Inequality operator*/
+		bool operator!=(const iterator &other) const { return !(current == other.current); }
+
+	private:
+		baseIterator current;		/**< Position in the underlying view*/
+		const transformView *owner; /**< The view*/
+	};
+
+	/** Creates view
+	 * @param _base - underlying view
+	 * @param _f - function applied to the elements
+	 */
+	transformView(const View &_base, Function _f) : base(_base), f(_f) {}
+	/** Returns iterator to the first element*/
+	iterator begin() const { return iterator(base.begin(), this); }
+	/** Returns iterator past the last element*/
+	iterator end() const { return iterator(base.end(), this); }
+};
+
+template <class View>
+/**View of at most 'count' first elements*/
+class takeView : public listView<takeView<View>>
+{
+private:
+	using baseIterator = decltype(std::declval<const View &>().begin());
+
+	View base;	  /**< Underlying view*/
+	size_t limit; /**< Maximal number of elements*/
+
+public:
+	/** Iterator counting elements, it is at the end after 'limit' elements or at the end of the underlying view*/
+	class iterator
+	{
+	public:
+		using iterator_category = typename std::iterator_traits<baseIterator>::iterator_category;
+		using value_type = typename std::iterator_traits<baseIterator>::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = typename std::iterator_traits<baseIterator>::pointer;
+		using reference = typename std::iterator_traits<baseIterator>::reference;
+
+		/** Constructor for an iterator object
+		 * @param _current - position in the underlying view
+		 * @param _index - number of elements before the position
+		 * @param _owner - the view
+		 */
+		iterator(baseIterator _current, size_t _index, const takeView *_owner) : current(_current), index(_index), owner(_owner) {}
+		/** Dereference operator*/
+		reference operator*() const { return *current; }
+		/** Moves the iterator to the next element*/
+		iterator &operator++()
+		{
+			++current;
+			++index;
+			return *this;
+		}
+		/** Moves the iterator to the previous element. The position of end() is not known until it is
+		 * decremented, then it is found by walking from the beginning.
+		 */
+		iterator &operator--()
+		{
+			if (atEnd())
+			{
+				current = owner->base.begin();
+				baseIterator last = owner->base.end();
+				for (index = 0; index < owner->limit && current != last; index++)
+					++current;
+			}
+			--current;
+			--index;
+			return *this;
+		}
+		/** Equality operator, all iterators at the end are equal*/
+		bool operator==(const iterator &other) const
+		{
+			bool end = atEnd();
+			return end == other.atEnd() && (end || current == other.current);
+		}
+		/** Inequality operator*/
+		bool operator!=(const iterator &other) const { return !(*this == other); }
+
+	private:
+		/** Checks if the iterator is past the last element of the view*/
+		bool atEnd() const { return index >= owner->limit || current == owner->base.end(); }
+
+		baseIterator current;	/**< Position in the underlying view*/
+		size_t index;			/**< Number of elements before the position*/
+		const takeView *owner;	/**< The view*/
+	};
+
+	/** Creates view
+	 * @param _base - underlying view
+	 * @param _limit - maximal number of elements
+	 */
+	takeView(const View &_base, size_t _limit) : base(_base), limit(_limit) {}
+	/** Returns iterator to the first element*/
+	iterator begin() const { return iterator(base.begin(), 0, this); }
+	/** Returns iterator past the last element*/
+	iterator end() const { return iterator(base.end(), limit, this); }
+};
+
+template <class View>
+/**View without 'count' first elements, they are skipped when begin() is called*/
+class dropView : public listView<dropView<View>>
+{
+private:
+	View base;	  /**< Underlying view*/
+	size_t skip; /**< Number of elements to skip*/
+
+public:
+	using iterator = decltype(std::declval<const View &>().begin());
+
+	/** Creates view
+	 * @param _base - underlying view
+	 * @param _skip - number of elements to skip
+	 */
+	dropView(const View &_base, size_t _skip) : base(_base), skip(_skip) {}
+	/** Returns iterator to the first element after the skipped ones, O(skip)*/
+	iterator begin() const
+	{
+		iterator current = base.begin();
+		iterator last = base.end();
+		for (size_t i = 0; i < skip && current != last; i++)
+			++current;
+		return current;
+	}
+	/** Returns iterator past the last element*/
+	iterator end() const { return base.end(); }
+};
+
+template <class View>
+/**View of the elements in reverse order, the underlying view has to be bidirectional*/
+class reverseView : public listView<reverseView<View>>
+{
+private:
+	using baseIterator = decltype(std::declval<const View &>().begin());
+
+	View base; /**< Underlying view*/
+
+public:
+	/** Iterator walking the underlying view backwards, it keeps position after the element it points to*/
+	class iterator
+	{
+	public:
+		using iterator_category = typename std::iterator_traits<baseIterator>::iterator_category;
+		using value_type = typename std::iterator_traits<baseIterator>::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = typename std::iterator_traits<baseIterator>::pointer;
+		using reference = typename std::iterator_traits<baseIterator>::reference;
+
+		/** Constructor for an iterator object
+		 * @param _current - position in the underlying view after the element
+		 */
+		explicit iterator(baseIterator _current) : current(_current) {}
+		/** Dereference operator
+		 * @return The element before the position in the underlying view
+		 */
+		reference operator*() const
+		{
+			baseIterator element = current;
+			--element;
+			return *element;
+		}
+		/** Moves the iterator to the next element (the previous one in the underlying view)*/
+		iterator &operator++()
+		{
+			--current;
+			return *this;
+		}
+		/** Moves the iterator to the previous element (the next one in the underlying view)*/
+		iterator &operator--()
+		{
+			++current;
+			return *this;
+		}
+		/** Equality operator*/
+		bool operator==(const iterator &other) const { return current == other.current; }
+		/** Inequality operator*/
+		bool operator!=(const iterator &other) const { return !(current == other.current); }
+
+	private:
+		baseIterator current; /**< Position in the underlying view after the element*/
+	};
+
+	/** Creates view
+	 * @param _base - underlying view
+	 */
+	explicit reverseView(const View &_base) : base(_base) {}
+	/** Returns iterator to the last element of the underlying view*/
+	iterator begin() const { return iterator(base.end()); }
+	/** Returns iterator before the first element of the underlying view*/
+	iterator end() const { return iterator(base.begin()); }
+};
+
+template <class View, class OtherView>
+/**View of pairs of elements of two views, it ends with the shorter one. Pairs hold references
+ * to the elements (or results of transform views), iterators are forward only.
+ */
+class zipView : public listView<zipView<View, OtherView>>
+{
+private:
+	using firstIterator = decltype(std::declval<const View &>().begin());
+	using secondIterator = decltype(std::declval<const OtherView &>().begin());
+	using firstReference = typename std::iterator_traits<firstIterator>::reference;
+	using secondReference = typename std::iterator_traits<secondIterator>::reference;
+
+	View first;		   /**< First view*/
+	OtherView second; /**< Second view*/
+
+public:
+	/** Iterator moving through both views at once*/
+	class iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::pair<std::decay_t<firstReference>, std::decay_t<secondReference>>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::pair<firstReference, secondReference>;
+
+		/** Constructor for an iterator object
+		 * @param _first - position in the first view
+		 * @param _second - position in the second view
+		 */
+		iterator(firstIterator _first, secondIterator _second) : currentFirst(_first), currentSecond(_second) {}
+		/** Dereference operator
+		 * @return Pair of the elements
+		 */
+		reference operator*() const { return reference(*currentFirst, *currentSecond); }
+		/** Moves the iterator to the next pair*/
+		iterator &operator++()
+		{
+			++currentFirst;
+			++currentSecond;
+			return *this;
+		}
+		/** Equality operator, iterators are equal if they are equal in any of the views, so that the shorter view ends the iteration*/
+		bool operator==(const iterator &other) const { return currentFirst == other.currentFirst || currentSecond == other.currentSecond; }
+		/** Inequality operator*/
+		bool operator!=(const iterator &other) const { return !(*this == other); }
+
+	private:
+		firstIterator currentFirst;	  /**< Position in the first view*/
+		secondIterator currentSecond; /**< Position in the second view*/
+	};
+
+	/** Creates view
+	 * @param _first - first view
+	 * @param _second - second view
+	 */
+	zipView(const View &_first, const OtherView &_second) : first(_first), second(_second) {}
+	/** Returns iterator to the first pair*/
+	iterator begin() const { return iterator(first.begin(), second.begin()); }
+	/** Returns iterator past the last pair*/
+	iterator end() const { return iterator(first.end(), second.end()); }
+};
+
+#endif /* LIST_VIEWS_H */
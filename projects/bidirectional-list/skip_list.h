@@ -0,0 +1,152 @@
+/**
+ * @file skip_list.h
+ * @brief Skeleton shared by the lists built on skip list levels (indexed_list and sorted_list)
+ *
+ */
+
+#pragma once
+
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+template <class Link>
+/**Links of a single node of a skip list, also used alone as the list sentinel.
+ * @tparam Link - link on one level, it has 'next' and 'previous' pointers to skipListLinks<Link> and may hold more
+ */
+struct skipListLinks
+{
+	int level;	 /**< Number of levels the node takes part in, level 0 is the ordinary list*/
+	Link *links; /**< Array of 'level' links*/
+};
+
+template <class Link, class Node>
+/**Base of the lists built on skip list levels, it owns the sentinel and the nodes.
+ *
+ * Level 0 links form an ordinary circular doubly linked list around the sentinel, every node also takes part
+ * in a random number of higher levels. The base draws levels, allocates and frees nodes, and moves the nodes
+ * between lists; how nodes are found and linked in is up to the derived list.
+ * @tparam Link - link on one level, aggregate starting with 'next' and 'previous'; the link {&sentinel, &sentinel} has to describe an empty level
+ * @tparam Node - node type derived from skipListLinks<Link>, with the element in 'data'
+ */
+class skipListBase
+{
+protected:
+	using links = skipListLinks<Link>;
+
+	static constexpr int maxLevel = 16; /**< Maximal number of levels, enough for 4^16 elements*/
+
+	links sentinel;				  /**< Sentinel, stands before the first and after the last element on every level*/
+	Link sentinelLinks[maxLevel]; /**< Links of the sentinel*/
+	int levelCount = 1;			  /**< Number of levels in use*/
+	size_t size = 0;			  /**< Size of the list*/
+	uint32_t seed = 2463534242u;  /**< State of the generator used for node levels*/
+
+	/** Creates empty list*/
+	skipListBase() { resetSentinel(); }
+	skipListBase(const skipListBase &) = delete;
+	skipListBase &operator=(const skipListBase &) = delete;
+	/** Frees all nodes*/
+	~skipListBase() { destroyNodes(); }
+
+	/** Draws level of a new node, every next level is taken with probability 1/4
+	 * @return Level from 1 to maxLevel
+	 */
+	int randomLevel()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		int level = 1;
+		uint32_t bits = seed;
+		while ((bits & 3) == 0 && level < maxLevel)
+		{
+			++level;
+			bits >>= 2;
+		}
+		return level;
+	}
+	/** Returns element stored in a node
+	 * @param node - node other than the sentinel
+	 * @return Reference to the element
+	 */
+	static auto &dataOf(links *node) { return static_cast<Node *>(node)->data; }
+	/** Allocates node with random level, links are left unset
+	 * @param args - arguments passed to the constructor of the node
+	 * @return Pointer to the new node
+	 */
+	template <class... Args>
+	Node *createNode(Args &&...args)
+	{
+		Node *node = new Node(std::forward<Args>(args)...);
+		node->level = randomLevel();
+		try
+		{
+			node->links = new Link[node->level];
+		}
+		catch (...)
+		{
+			delete node;
+			throw;
+		}
+		return node;
+	}
+	/** Frees node and its links
+	 * @param node - node to destroy, it has to be unlinked from the list
+	 */
+	static void destroyNode(links *node)
+	{
+		delete[] node->links;
+		delete static_cast<Node *>(node);
+	}
+	/** Resets the sentinel to an empty list, nodes are not freed*/
+	void resetSentinel()
+	{
+		sentinel.level = maxLevel;
+		sentinel.links = sentinelLinks;
+		sentinelLinks[0] = {&sentinel, &sentinel};
+		levelCount = 1;
+		size = 0;
+	}
+	/** Frees all nodes and resets the sentinel*/
+	void destroyNodes()
+	{
+		links *pointrr = sentinelLinks[0].next;
+		while (pointrr != &sentinel)
+		{
+			links *temp = pointrr;
+			pointrr = pointrr->links[0].next;
+			destroyNode(temp);
+		}
+		resetSentinel();
+	}
+	/** Takes all nodes of the other list, which becomes empty. The sentinel cannot move, so the nodes next to it are relinked.
+	 * This list has to be empty.
+	 * @param other - list to take the nodes from
+	 */
+	void takeNodes(skipListBase &other) noexcept
+	{
+		levelCount = other.levelCount;
+		size = other.size;
+		for (int l = 0; l < levelCount; ++l)
+		{
+			sentinelLinks[l] = other.sentinelLinks[l];
+			if (sentinelLinks[l].next == &other.sentinel)
+			{
+				sentinelLinks[l].next = &sentinel;
+				sentinelLinks[l].previous = &sentinel;
+			}
+			else
+			{
+				sentinelLinks[l].next->links[l].previous = &sentinel;
+				sentinelLinks[l].previous->links[l].next = &sentinel;
+			}
+		}
+		other.resetSentinel();
+	}
+};
+
+#endif /* SKIP_LIST_H */
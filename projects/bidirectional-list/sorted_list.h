@@ -0,0 +1,419 @@
+/**
+ * @file sorted_list.h
+ * @brief Bidirectional list which keeps its elements sorted, with skip list express lanes for searching
+ *
+ */
+
+#pragma once
+
+#ifndef SORTED_LIST_H
+#define SORTED_LIST_H
+
+#include "functions.h"
+#include "skip_list.h"
+
+#include <cstdint>
+
+struct sortedListLink;
+/**Links of a single node of 'sorted_list' class, also used alone as the list sentinel*/
+using sortedListLinks = skipListLinks<sortedListLink>;
+
+/**Link on one level of 'sorted_list' class*/
+struct sortedListLink
+{
+	sortedListLinks *next;	   /**< Next node on this level, sentinel after the last one*/
+	sortedListLinks *previous; /**< Previous node on this level, sentinel before the first one*/
+};
+
+template <class T>
+/**Struct used to store data, node of 'sorted_list' class*/
+struct sortedListNode : sortedListLinks
+{
+	T data; /**< Data stored in node*/
+	/** Node constructor, links are left unset
+	 * @param elem - data to store in the node
+	 */
+	sortedListNode(const T &elem) : data(elem) {}
+};
+
+template <class T, class Compare = std::less<T>>
+/**Bidirectional list which keeps its elements ordered by 'Compare'.
+ *
+ * Level 0 links form an ordinary circular doubly linked list around a sentinel, every node also takes part
+ * in a random number of higher levels (express lanes), so the place of an element is found like in a skip list.
+ * insert(), lower_bound(), upper_bound() and equal_range() are O(log n) expected, walking a range found
+ * by them costs O(k) for k elements. Inserting an element not lower than the last one (e.g. sorted input)
+ * and removing elements never searches. Equal elements are kept in insertion order.
+ * Searching functions take any key the comparator can compare with elements in both orders, e.g.
+ * with a comparator of people by age, lower_bound(16) to upper_bound(32) are all people aged 16 to 32.
+ */
+class sorted_list : private skipListBase<sortedListLink, sortedListNode<T>>
+{
+private:
+	using base = skipListBase<sortedListLink, sortedListNode<T>>;
+	using link = sortedListLink;
+	using base::maxLevel;
+	using base::sentinel;
+	using base::sentinelLinks;
+	using base::levelCount;
+	using base::size;
+	using base::dataOf;
+	using base::createNode;
+	using base::destroyNode;
+
+	Compare comp; /**< Comparator defining order of the elements*/
+
+	/** Finds the last node on every level for which 'goesBefore' is true (nodes are searched from the beginning)
+	 * @param goesBefore - predicate true for a prefix of the list
+	 * @param update - filled with the last node of the prefix on every level in use, or the sentinel
+	 * @return The last node of the prefix on level 0, or the sentinel
+	 */
+	template <class Predicate>
+	sortedListLinks *findLast(Predicate goesBefore, sortedListLinks **update)
+	{
+		sortedListLinks *pointrr = &sentinel;
+		for (int l = levelCount - 1; l >= 0; --l)
+		{
+			while (pointrr->links[l].next != &sentinel && goesBefore(dataOf(pointrr->links[l].next)))
+				pointrr = pointrr->links[l].next;
+			if (update != nullptr)
+				update[l] = pointrr;
+		}
+		return pointrr;
+	}
+	/** Finds first node not lower than the key
+	 * @param key - the key
+	 * @return The node or the sentinel
+	 */
+	template <class Key>
+	sortedListLinks *lowerBoundNode(const Key &key)
+	{
+		return findLast([this, &key](T &elem)
+						{ return comp(elem, key); },
+						nullptr)
+			->links[0]
+			.next;
+	}
+	/** Finds first node greater than the key
+	 * @param key - the key
+	 * @return The node or the sentinel
+	 */
+	template <class Key>
+	sortedListLinks *upperBoundNode(const Key &key)
+	{
+		return findLast([this, &key](T &elem)
+						{ return !comp(key, elem); },
+						nullptr)
+			->links[0]
+			.next;
+	}
+	/** Unlinks and destroys node, the sentinel cannot be removed
+	 * @param node - node to remove
+	 * @return Data stored in the node
+	 */
+	T removeNode(sortedListLinks *node)
+	{
+		for (int l = 0; l < node->level; ++l)
+		{
+			node->links[l].previous->links[l].next = node->links[l].next;
+			node->links[l].next->links[l].previous = node->links[l].previous;
+		}
+		while (levelCount > 1 && sentinelLinks[levelCount - 1].next == &sentinel)
+			--levelCount;
+		--size;
+		T val = std::move(dataOf(node));
+		destroyNode(node);
+		return val;
+	}
+
+public:
+	/** Bidirectional iterator class, walks level 0 of the list. Elements cannot be changed through it,
+	 * because that could break the order.
+	 */
+	class iterator
+	{
+		friend class sorted_list<T, Compare>;
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T *;
+		using reference = const T &;
+
+		/** Constructor for an iterator object
+		 * @param p - pointer to the node that the iterator will point
+		 */
+		iterator(sortedListLinks *p) : ptr(p) {}
+		/** Dereference operator
+		 * @return Returns reference to the element stored in the node
+		 */
+		const T &operator*() const { return dataOf(ptr); }
+		/** Gives access to members of the element*/
+		const T *operator->() const { return &dataOf(ptr); }
+		/** Increment operator - iterator is moved to the next node in the list
+		 * @return reference to the next node
+		 */
+		iterator &operator++()
+		{
+			ptr = ptr->links[0].next;
+			return *this;
+		}
+		/** Decrement operator - iterator is moved to the previous node in the list, end() can be decremented
+		 * @return reference to the previous node
+		 */
+		iterator &operator--()
+		{
+			ptr = ptr->links[0].previous;
+			return *this;
+		}
+		/** Equality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the same node, false otherwise
+		 */
+		bool operator==(const iterator &other) const { return ptr == other.ptr; }
+		/** Inequality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the different node, false otherwise
+		 */
+		bool operator!=(const iterator &other) const { return ptr != other.ptr; }
+
+	private:
+		sortedListLinks *ptr; /**< A pointer to the node, used to traverse the list*/
+	};
+
+	/** Default list constructor, creates blank list
+	 * @param _comp - comparator defining the order
+	 */
+	explicit sorted_list(Compare _comp = Compare()) : comp(_comp) {}
+	/** Creates sorted list holding all elements of the other list
+	 * @param otherList - list to take the elements from
+	 * @param _comp - comparator defining the order
+	 */
+	explicit sorted_list(list<T> &otherList, Compare _comp = Compare()) : sorted_list(_comp)
+	{
+		for (T &elem : otherList)
+			insert(elem);
+	}
+	/** Copy constructor, creates a copy of the other list*/
+	sorted_list(const sorted_list &otherList) : sorted_list(otherList.comp)
+	{
+		for (sortedListLinks *pointrr = otherList.sentinel.links[0].next; pointrr != &otherList.sentinel; pointrr = pointrr->links[0].next)
+			insert(dataOf(pointrr));
+	}
+	/** Move constructor*/
+	sorted_list(sorted_list &&otherList) noexcept : sorted_list(otherList.comp) { *this = std::move(otherList); }
+	/** Copy assignment operator
+	 * @param otherList - the list to copy the contents from
+	 * @return A reference to the current list with the copied contents
+	 */
+	sorted_list &operator=(const sorted_list &otherList)
+	{
+		if (this != &otherList)
+		{
+			clear();
+			comp = otherList.comp;
+			for (sortedListLinks *pointrr = otherList.sentinel.links[0].next; pointrr != &otherList.sentinel; pointrr = pointrr->links[0].next)
+				insert(dataOf(pointrr));
+		}
+		return *this;
+	}
+	/** Move assignment operator, the sentinel cannot move, so the nodes next to it are relinked
+	 * @param otherList - the list to move the contents from
+	 * @return A reference to the current list with the moved contents
+	 */
+	sorted_list &operator=(sorted_list &&otherList) noexcept
+	{
+		if (this != &otherList)
+		{
+			clear();
+			comp = otherList.comp;
+			base::takeNodes(otherList);
+		}
+		return *this;
+	}
+
+	/** Inserts element at its place in the order, after all elements equal to it
+	 * @param elem - element to add
+	 * @return Iterator to the new element
+	 */
+	iterator insert(const T &elem)
+	{
+		// The place is found before the node is created, so a throwing comparator leaves the list unchanged
+		sortedListLinks *update[maxLevel];
+		if (size == 0 || !comp(elem, dataOf(sentinelLinks[0].previous)))
+		{
+			for (int l = 0; l < levelCount; ++l)
+				update[l] = sentinelLinks[l].previous;
+		}
+		else
+		{
+			findLast([this, &elem](T &other)
+					 { return !comp(elem, other); },
+					 update);
+		}
+		for (int l = levelCount; l < maxLevel; ++l)
+			update[l] = &sentinel;
+		sortedListNode<T> *node = createNode(elem);
+		for (; levelCount < node->level; ++levelCount)
+			sentinelLinks[levelCount] = {&sentinel, &sentinel};
+		for (int l = 0; l < node->level; ++l)
+		{
+			node->links[l] = {update[l]->links[l].next, update[l]};
+			update[l]->links[l].next->links[l].previous = node;
+			update[l]->links[l].next = node;
+		}
+		++size;
+		return iterator(node);
+	}
+	/** Removes element
+	 * @param position - iterator to the element to remove
+	 * @return Iterator to the element after the removed one
+	 */
+	iterator erase(iterator position)
+	{
+		if (position.ptr == &sentinel)
+			throw myException(errorType::outOfRange);
+		sortedListLinks *next = position.ptr->links[0].next;
+		removeNode(position.ptr);
+		return iterator(next);
+	}
+	/** Removes all elements equal to the key
+	 * @param key - the key
+	 * @return Number of removed elements
+	 */
+	template <class Key>
+	size_t erase_equal(const Key &key)
+	{
+		size_t count = 0;
+		sortedListLinks *pointrr = lowerBoundNode(key);
+		while (pointrr != &sentinel && !comp(key, dataOf(pointrr)))
+		{
+			sortedListLinks *next = pointrr->links[0].next;
+			removeNode(pointrr);
+			pointrr = next;
+			++count;
+		}
+		return count;
+	}
+	/** Returns iterator to the first element not lower than the key
+	 * @param key - the key
+	 * @return Iterator to the element or end()
+	 */
+	template <class Key>
+	iterator lower_bound(const Key &key) { return iterator(lowerBoundNode(key)); }
+	/** Returns iterator to the first element greater than the key
+	 * @param key - the key
+	 * @return Iterator to the element or end()
+	 */
+	template <class Key>
+	iterator upper_bound(const Key &key) { return iterator(upperBoundNode(key)); }
+	/** Returns range of elements equal to the key
+	 * @param key - the key
+	 * @return Pair of lower_bound(key) and upper_bound(key)
+	 */
+	template <class Key>
+	std::pair<iterator, iterator> equal_range(const Key &key)
+	{
+		sortedListLinks *first = lowerBoundNode(key);
+		sortedListLinks *last = first;
+		while (last != &sentinel && !comp(key, dataOf(last)))
+			last = last->links[0].next;
+		return {iterator(first), iterator(last)};
+	}
+	/** Finds first element equal to the key
+	 * @param key - the key
+	 * @return Iterator to the element or end() if there is none
+	 */
+	template <class Key>
+	iterator find(const Key &key)
+	{
+		sortedListLinks *node = lowerBoundNode(key);
+		if (node != &sentinel && comp(key, dataOf(node)))
+			node = &sentinel;
+		return iterator(node);
+	}
+	/** Counts elements equal to the key
+	 * @param key - the key
+	 * @return Number of elements
+	 */
+	template <class Key>
+	size_t count(const Key &key)
+	{
+		auto range = equal_range(key);
+		size_t count = 0;
+		for (; range.first != range.second; ++range.first)
+			++count;
+		return count;
+	}
+	/** Returns contents of the last (greatest) element in the list
+	 * @return Reference to the last element in the list
+	 */
+	const T &back()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return dataOf(sentinelLinks[0].previous);
+	}
+	/** Returns contents of the first (lowest) element in the list
+	 * @return Reference to the first element in the list
+	 */
+	const T &front()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return dataOf(sentinelLinks[0].next);
+	}
+	/** Checks if the container is empty
+	 * @return true if the container is empty, false otherwise
+	 */
+	bool empty() { return size == 0; }
+	/** Returns the number of elements in the list
+	 * @return The number of elements in the list
+	 */
+	size_t getSize() { return size; }
+	/** Deletes the last (greatest) element and returns it
+	 * @return Deleted element
+	 */
+	T pop_back()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return removeNode(sentinelLinks[0].previous);
+	}
+	/** Deletes the first (lowest) element and returns it
+	 * @return Deleted element
+	 */
+	T pop_front()
+	{
+		if (size == 0)
+			throw myException(errorType::emptyList);
+		return removeNode(sentinelLinks[0].next);
+	}
+	/** Method displays all elements of the list*/
+	void display()
+	{
+		if (size == 0)
+		{
+			std::cout << "\t/Empty list!/" << std::endl;
+		}
+		else
+		{
+			for (sortedListLinks *pointrr = sentinelLinks[0].next; pointrr != &sentinel; pointrr = pointrr->links[0].next)
+				std::cout << dataOf(pointrr) << std::endl;
+		}
+	}
+	/** Clears the memory by removing all nodes from the list*/
+	void clear() { base::destroyNodes(); }
+
+	/** Returns an iterator pointing to the first element of the list
+	 * @return Iterator pointing to the first element of the list
+	 */
+	iterator begin() { return iterator(sentinelLinks[0].next); }
+	/** Returns an iterator pointing to the end of the list (the sentinel)
+	 * @return Iterator pointing to the end of the list
+	 */
+	iterator end() { return iterator(&sentinel); }
+};
+
+#endif /* SORTED_LIST_H */
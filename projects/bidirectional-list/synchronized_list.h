@@ -0,0 +1,425 @@
+/**
+ * @file synchronized_list.h
+ * @brief Thread-safe bidirectional list with a lock in every node
+ *
+ */
+
+#pragma once
+
+#ifndef SYNCHRONIZED_LIST_H
+#define SYNCHRONIZED_LIST_H
+
+#include "functions.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/**Links of a single node of 'synchronized_list' class, also used alone for both sentinels.
+ * Links and 'removed' may be read or changed only while 'lock' is held.
+ */
+struct synchronizedListLinks
+{
+	std::shared_ptr<synchronizedListLinks> nextNodePtr;	/**< Next node, kept by a removed node so its iterators can go on*/
+	std::weak_ptr<synchronizedListLinks> previousNodePtr; /**< Previous node*/
+	std::mutex lock;									/**< Lock guarding links of this node*/
+	bool removed = false;								/**< True once the node is unlinked from the list*/
+
+	synchronizedListLinks() = default;
+	synchronizedListLinks(const synchronizedListLinks &) = delete;
+	synchronizedListLinks &operator=(const synchronizedListLinks &) = delete;
+	/** Links destructor. Removed nodes owned only by their predecessor are released in a loop, not recursively,
+	 * so a long chain of them can not overflow the stack.
+	 */
+	~synchronizedListLinks()
+	{
+		std::shared_ptr<synchronizedListLinks> pointrr = std::move(nextNodePtr);
+		while (pointrr != nullptr && pointrr.use_count() == 1)
+		{
+			std::shared_ptr<synchronizedListLinks> next;
+			{
+				std::lock_guard<std::mutex> guard(pointrr->lock);
+				next = std::move(pointrr->nextNodePtr);
+			}
+			pointrr = std::move(next);
+		}
+	}
+};
+
+template <class T>
+/**Struct used to store data, node of 'synchronized_list' class*/
+struct synchronizedListNode : synchronizedListLinks
+{
+	const T data; /**< Data stored in node, never changed, so it can be read without locking*/
+	/** Node constructor, links are left empty
+	 * @param args - arguments forwarded to the constructor of T
+	 */
+	template <class... Args>
+	explicit synchronizedListNode(std::in_place_t, Args &&...args) : data(std::forward<Args>(args)...) {}
+};
+
+template <class T>
+/**Bidirectional list which can be read and modified by many threads at once.
+ *
+ * Every node has its own lock, an operation locks only the nodes it relinks: the node before, the node itself
+ * and the node after. Locks are taken from left to right, a lock on the left side of an already held one is only
+ * tried, and on failure everything is released and the operation starts again, so threads can not deadlock.
+ * Threads working on distant parts of the list never wait for each other.
+ *
+ * Traversal (iterators, display(), search(), find()) holds at most one lock at a time and only for reading a link.
+ * Nodes are reference counted, so an iterator stays safe even if its own element is removed: the element can
+ * still be read and ++ continues with the nodes which followed it. Elements are immutable, so they are read
+ * without locking, pops return copies.
+ */
+class synchronized_list
+{
+private:
+	using links = synchronizedListLinks;
+	using node = synchronizedListNode<T>;
+
+	std::shared_ptr<links> head;  /**< Sentinel before the first element*/
+	std::shared_ptr<links> tail;  /**< Sentinel after the last element*/
+	std::atomic<size_t> size{0}; /**< Size of the list*/
+
+	/** Links new node in between two nodes, both have to be locked and adjacent
+	 * @param before - node which will be before the new one
+	 * @param after - node which will be after the new one
+	 * @param n - new node
+	 */
+	static void linkBetween(const std::shared_ptr<links> &before, const std::shared_ptr<links> &after, const std::shared_ptr<links> &n)
+	{
+		n->previousNodePtr = before;
+		n->nextNodePtr = after;
+		before->nextNodePtr = n;
+		after->previousNodePtr = n;
+	}
+	/** Links node in after given one
+	 * @param before - node which will be before the new one, it must not be removed
+	 * @param n - new node
+	 */
+	void insertAfter(const std::shared_ptr<links> &before, const std::shared_ptr<links> &n)
+	{
+		std::lock_guard<std::mutex> beforeGuard(before->lock);
+		std::shared_ptr<links> after = before->nextNodePtr;
+		std::lock_guard<std::mutex> afterGuard(after->lock);
+		linkBetween(before, after, n);
+		size.fetch_add(1, std::memory_order_relaxed);
+	}
+	/** Links node in before given one
+	 * @param after - node which will be after the new one
+	 * @param n - new node
+	 * @return false if 'after' has been removed
+	 */
+	bool insertBefore(const std::shared_ptr<links> &after, const std::shared_ptr<links> &n)
+	{
+		while (true)
+		{
+			std::unique_lock<std::mutex> afterGuard(after->lock);
+			if (after->removed)
+				return false;
+			std::shared_ptr<links> before = after->previousNodePtr.lock();
+			std::unique_lock<std::mutex> beforeGuard(before->lock, std::try_to_lock);
+			if (!beforeGuard.owns_lock())
+			{
+				afterGuard.unlock();
+				std::this_thread::yield();
+				continue;
+			}
+			linkBetween(before, after, n);
+			size.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	/** Unlinks node from the list
+	 * @param n - node to unlink
+	 * @param expectedBefore - if not nullptr, node is unlinked only if it follows this one
+	 * @param expectedAfter - if not nullptr, node is unlinked only if this one follows it
+	 * @return false if the node has already been removed or has other neighbours than expected
+	 */
+	bool unlinkNode(const std::shared_ptr<links> &n, const links *expectedBefore, const links *expectedAfter)
+	{
+		while (true)
+		{
+			std::unique_lock<std::mutex> nodeGuard(n->lock);
+			if (n->removed)
+				return false;
+			std::shared_ptr<links> before = n->previousNodePtr.lock();
+			std::shared_ptr<links> after = n->nextNodePtr;
+			if ((expectedBefore != nullptr && before.get() != expectedBefore) || (expectedAfter != nullptr && after.get() != expectedAfter))
+				return false;
+			std::unique_lock<std::mutex> beforeGuard(before->lock, std::try_to_lock);
+			if (!beforeGuard.owns_lock())
+			{
+				nodeGuard.unlock();
+				std::this_thread::yield();
+				continue;
+			}
+			std::lock_guard<std::mutex> afterGuard(after->lock);
+			before->nextNodePtr = after;
+			after->previousNodePtr = before;
+			n->removed = true;
+			size.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	/** Reads link of a node under its lock
+	 * @param n - node
+	 * @return Next node
+	 */
+	static std::shared_ptr<links> nextOf(const std::shared_ptr<links> &n)
+	{
+		std::lock_guard<std::mutex> guard(n->lock);
+		return n->nextNodePtr;
+	}
+	/** Reads link of a node under its lock
+	 * @param n - node
+	 * @return Previous node, nullptr if the node is removed and its previous node does not exist anymore
+	 */
+	static std::shared_ptr<links> previousOf(const std::shared_ptr<links> &n)
+	{
+		std::lock_guard<std::mutex> guard(n->lock);
+		return n->previousNodePtr.lock();
+	}
+	/** Unlinks the first node
+	 * @return Unlinked node, nullptr if the list is empty
+	 */
+	std::shared_ptr<links> unlinkFirst()
+	{
+		while (true)
+		{
+			std::shared_ptr<links> first = nextOf(head);
+			if (first == tail)
+				return nullptr;
+			if (unlinkNode(first, head.get(), nullptr))
+				return first;
+		}
+	}
+	/** Unlinks the last node
+	 * @return Unlinked node, nullptr if the list is empty
+	 */
+	std::shared_ptr<links> unlinkLast()
+	{
+		while (true)
+		{
+			std::shared_ptr<links> last = previousOf(tail);
+			if (last == head)
+				return nullptr;
+			if (unlinkNode(last, nullptr, tail.get()))
+				return last;
+		}
+	}
+	/** Creates node holding a new element
+	 * @param args - arguments forwarded to the constructor of T
+	 * @return Pointer to the node
+	 */
+	template <class... Args>
+	static std::shared_ptr<links> createNode(Args &&...args)
+	{
+		return std::make_shared<node>(std::in_place, std::forward<Args>(args)...);
+	}
+
+public:
+	/** Bidirectional iterator, safe to use while other threads modify the list*/
+	class iterator
+	{
+		friend class synchronized_list<T>;
+		std::shared_ptr<links> current; /**< Node the iterator points to, the node (and every node after it) is kept alive by the iterator*/
+
+		iterator(std::shared_ptr<links> n) : current(std::move(n)) {}
+
+	public:
+		/** Returns element the iterator points to, elements are immutable*/
+		const T &operator*() const { return static_cast<node *>(current.get())->data; }
+		/** Gives access to members of the element*/
+		const T *operator->() const { return &static_cast<node *>(current.get())->data; }
+		/** Moves to the next element. Iterator on a removed element follows the nodes which were after it.
+		 * Only the tail sentinel has no next node, so end() stays where it is; the list itself is never read.
+		 */
+		iterator &operator++()
+		{
+			std::shared_ptr<links> next = nextOf(current);
+			if (next != nullptr)
+				current = std::move(next);
+			return *this;
+		}
+		/** Moves to the previous element, throws outOfRange if the element was removed and nothing is left before it*/
+		iterator &operator--()
+		{
+			std::shared_ptr<links> previous = previousOf(current);
+			if (previous == nullptr)
+				throw myException(errorType::outOfRange);
+			current = std::move(previous);
+			return *this;
+		}
+		bool operator==(const iterator &other) const { return current == other.current; }
+		bool operator!=(const iterator &other) const { return current != other.current; }
+	};
+
+	/** Default list constructor, creates empty list*/
+	synchronized_list() : head(std::make_shared<links>()), tail(std::make_shared<links>())
+	{
+		head->nextNodePtr = tail;
+		tail->previousNodePtr = head;
+	}
+	synchronized_list(const synchronized_list<T> &) = delete;
+	synchronized_list<T> &operator=(const synchronized_list<T> &) = delete;
+	/** List destructor, no other thread may use the list anymore (iterators may outlive it)*/
+	~synchronized_list()
+	{
+		std::shared_ptr<links> pointrr = std::move(head->nextNodePtr);
+		while (pointrr != tail)
+		{
+			std::shared_ptr<links> next = pointrr->nextNodePtr;
+			pointrr->removed = true;
+			pointrr = std::move(next);
+		}
+	}
+
+	/** Adds element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(const T &elem) { insertBefore(tail, createNode(elem)); }
+	/** Adds element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(T &&elem) { insertBefore(tail, createNode(std::move(elem))); }
+	/** Adds element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(const T &elem) { insertAfter(head, createNode(elem)); }
+	/** Adds element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(T &&elem) { insertAfter(head, createNode(std::move(elem))); }
+	/** Inserts element before given position
+	 * @param position - iterator to the element before which the new one is inserted, may be end()
+	 * @param elem - element to insert
+	 * @return Iterator to the inserted element, throws outOfRange if the element at 'position' has been removed
+	 */
+	iterator insert(iterator position, const T &elem)
+	{
+		std::shared_ptr<links> n = createNode(elem);
+		if (!insertBefore(position.current, n))
+			throw myException(errorType::outOfRange);
+		return iterator(std::move(n));
+	}
+	/** Removes element at given position
+	 * @param position - iterator to the element to remove
+	 * @return false if the element has already been removed by another thread
+	 */
+	bool erase(iterator position)
+	{
+		if (position.current == head || position.current == tail)
+			throw myException(errorType::outOfRange);
+		return unlinkNode(position.current, nullptr, nullptr);
+	}
+
+	/** Removes the last element if there is one
+	 * @param elem - set to the removed element
+	 * @return false if the list was empty
+	 */
+	bool try_pop_back(T &elem)
+	{
+		std::shared_ptr<links> n = unlinkLast();
+		if (n == nullptr)
+			return false;
+		elem = static_cast<node *>(n.get())->data;
+		return true;
+	}
+	/** Removes the first element if there is one
+	 * @param elem - set to the removed element
+	 * @return false if the list was empty
+	 */
+	bool try_pop_front(T &elem)
+	{
+		std::shared_ptr<links> n = unlinkFirst();
+		if (n == nullptr)
+			return false;
+		elem = static_cast<node *>(n.get())->data;
+		return true;
+	}
+	/** Removes the last element, throws emptyList if there is none
+	 * @return Copy of the removed element
+	 */
+	T pop_back()
+	{
+		std::shared_ptr<links> n = unlinkLast();
+		if (n == nullptr)
+			throw myException(errorType::emptyList);
+		return static_cast<node *>(n.get())->data;
+	}
+	/** Removes the first element, throws emptyList if there is none
+	 * @return Copy of the removed element
+	 */
+	T pop_front()
+	{
+		std::shared_ptr<links> n = unlinkFirst();
+		if (n == nullptr)
+			throw myException(errorType::emptyList);
+		return static_cast<node *>(n.get())->data;
+	}
+	/** Removes all elements, elements pushed by other threads in the meantime may stay*/
+	void clear()
+	{
+		while (unlinkFirst() != nullptr)
+			;
+	}
+
+	/** Returns iterator to the first element*/
+	iterator begin() const { return iterator(nextOf(head)); }
+	/** Returns iterator past the last element, it can be decremented*/
+	iterator end() const { return iterator(tail); }
+	/** Finds the first element equal to given one
+	 * @param elem - element to search for
+	 * @return Iterator to the element, end() if there is none
+	 */
+	iterator find(const T &elem) const
+	{
+		iterator it = begin();
+		for (iterator last = end(); it != last; ++it)
+			if (*it == elem)
+				break;
+		return it;
+	}
+	/** Method displays all elements of the list*/
+	void display() const
+	{
+		iterator it = begin();
+		if (it == end())
+		{
+			std::cout << "\t/Empty list!/" << std::endl;
+			return;
+		}
+		for (; it != end(); ++it)
+			std::cout << *it << std::endl;
+	}
+	/** Search for an element in the list
+	 * @param elem - the elements to search for
+	 */
+	void search(const T &elem) const
+	{
+		int elemCounter = 0;
+		bool elemFound = false;
+		for (const T &data : *this)
+		{
+			if (elem == data)
+			{
+				std::cout << data << " at [" << elemCounter << "] position." << std::endl;
+				elemFound = true;
+			}
+			++elemCounter;
+		}
+		if (!elemFound)
+			std::cout << elem << " not found." << std::endl;
+	}
+	/** Checks if the list is empty
+	 * @return true if there are no elements at the moment of the call
+	 */
+	bool empty() const { return nextOf(head) == tail; }
+	/** Returns the number of elements, while other threads modify the list it is only an estimate
+	 * @return Number of elements
+	 */
+	size_t getSize() const { return size.load(std::memory_order_relaxed); }
+};
+
+#endif
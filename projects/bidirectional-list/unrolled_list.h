@@ -0,0 +1,591 @@
+/**
+ * @file unrolled_list.h
+ * @brief Unrolled bidirectional list - every node holds a small array of elements
+ *
+ */
+
+#pragma once
+
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include "functions.h"
+
+#include <algorithm>
+
+/** Default number of elements in one chunk, chunks are kept around 512 bytes, but never hold less than 8 elements*/
+template <class T>
+constexpr size_t defaultChunkCapacity = sizeof(T) * 8 > 512 ? 8 : 512 / sizeof(T);
+
+template <class T, size_t ChunkCapacity>
+/**Struct used to store data, node of 'unrolled_list' class. Elements are kept in one contiguous
+ * part of the array, from 'first' to 'first + count', so the chunk can grow in both directions.
+ */
+struct unrolledChunk
+{
+	alignas(T) unsigned char storage[ChunkCapacity * sizeof(T)]; /**< Memory for the elements*/
+	size_t first = 0;											 /**< Index of the first element in the array*/
+	size_t count = 0;											 /**< Number of elements in the chunk*/
+	unrolledChunk *previousChunkPtr = nullptr;					 /**< Pointer, which points to the previous chunk of the list*/
+	unrolledChunk *nextChunkPtr = nullptr;						 /**< Pointer, which points to the next chunk of the list*/
+
+	/** Returns slot of the array
+	 * @param slot - index in the array (not counted from 'first')
+	 * @return Pointer to the slot
+	 */
+	T *slotAt(size_t slot) { return std::launder(reinterpret_cast<T *>(storage)) + slot; }
+	/** Returns element of the chunk
+	 * @param i - position of the element in the chunk
+	 * @return Reference to the element
+	 */
+	T &operator[](size_t i) { return *slotAt(first + i); }
+	/** Moves element from one slot to another, empty one
+	 * @param from - slot with the element
+	 * @param to - empty slot
+	 */
+	void moveSlot(size_t from, size_t to)
+	{
+		new (slotAt(to)) T(std::move(*slotAt(from)));
+		slotAt(from)->~T();
+	}
+	/** Moves all elements so that they start at given slot
+	 * @param newFirst - new index of the first element
+	 */
+	void shiftTo(size_t newFirst)
+	{
+		if (newFirst < first)
+		{
+			for (size_t i = 0; i < count; i++)
+				moveSlot(first + i, newFirst + i);
+		}
+		else if (newFirst > first)
+		{
+			for (size_t i = count; i > 0; i--)
+				moveSlot(first + i - 1, newFirst + i - 1);
+		}
+		first = newFirst;
+	}
+};
+
+template <class T, size_t ChunkCapacity = defaultChunkCapacity<T>>
+/**Bidirectional list which stores several elements in every node (unrolled list).
+ *
+ * Public interface is the same as in 'list' class. Elements of one chunk lie next to each other in memory,
+ * so full scans take a cache miss once per chunk instead of once per element. Chunks are split when an insertion
+ * hits a full one and merged with the next chunk when removals leave them less than a quarter full.
+ */
+class unrolled_list
+{
+private:
+	using chunk = unrolledChunk<T, ChunkCapacity>;
+
+	chunk *head = nullptr; /**< First chunk of the list*/
+	chunk *tail = nullptr; /**< Last chunk of the list*/
+	size_t size = 0;	   /**< Size of the list*/
+
+	/** Allocates empty chunk and links it in after given chunk
+	 * @param after - chunk after which the new one is linked, nullptr to link it at the beginning
+	 * @return Pointer to the new chunk
+	 */
+	chunk *linkChunk(chunk *after)
+	{
+		chunk *tmp = new chunk;
+		tmp->previousChunkPtr = after;
+		tmp->nextChunkPtr = after != nullptr ? after->nextChunkPtr : head;
+		if (tmp->nextChunkPtr != nullptr)
+			tmp->nextChunkPtr->previousChunkPtr = tmp;
+		else
+			tail = tmp;
+		if (after != nullptr)
+			after->nextChunkPtr = tmp;
+		else
+			head = tmp;
+		return tmp;
+	}
+	/** Unlinks and frees empty chunk
+	 * @param c - chunk to free, it cannot hold any elements
+	 */
+	void unlinkChunk(chunk *c)
+	{
+		if (c->previousChunkPtr != nullptr)
+			c->previousChunkPtr->nextChunkPtr = c->nextChunkPtr;
+		else
+			head = c->nextChunkPtr;
+		if (c->nextChunkPtr != nullptr)
+			c->nextChunkPtr->previousChunkPtr = c->previousChunkPtr;
+		else
+			tail = c->previousChunkPtr;
+		delete c;
+	}
+	/** Finds chunk holding element at given position
+	 * @param position - position of the element, lower than size
+	 * @param offset - set to the position of the element inside the found chunk
+	 * @return Pointer to the chunk
+	 */
+	chunk *locate(size_t position, size_t &offset)
+	{
+		if (position < size / 2)
+		{
+			chunk *pointrr = head;
+			while (position >= pointrr->count)
+			{
+				position -= pointrr->count;
+				pointrr = pointrr->nextChunkPtr;
+			}
+			offset = position;
+			return pointrr;
+		}
+		chunk *pointrr = tail;
+		size_t fromEnd = size - position;
+		while (fromEnd > pointrr->count)
+		{
+			fromEnd -= pointrr->count;
+			pointrr = pointrr->previousChunkPtr;
+		}
+		offset = pointrr->count - fromEnd;
+		return pointrr;
+	}
+	/** Merges chunk with the next one if both fit into one chunk
+	 * @param c - chunk to merge
+	 */
+	void mergeWithNext(chunk *c)
+	{
+		chunk *next = c->nextChunkPtr;
+		if (next == nullptr || c->count + next->count > ChunkCapacity)
+			return;
+		c->shiftTo(0);
+		for (size_t i = 0; i < next->count; i++)
+		{
+			new (c->slotAt(c->count + i)) T(std::move((*next)[i]));
+			(*next)[i].~T();
+		}
+		c->count += next->count;
+		next->count = 0;
+		unlinkChunk(next);
+	}
+	/** Removes element from chunk, frees or merges the chunk when it gets too small
+	 * @param c - chunk with the element
+	 * @param offset - position of the element inside the chunk
+	 * @return Removed element
+	 */
+	T eraseFromChunk(chunk *c, size_t offset)
+	{
+		T val = std::move((*c)[offset]);
+		(*c)[offset].~T();
+		if (offset < c->count / 2)
+		{
+			for (size_t i = offset; i > 0; i--)
+				c->moveSlot(c->first + i - 1, c->first + i);
+			c->first++;
+		}
+		else
+		{
+			for (size_t i = offset + 1; i < c->count; i++)
+				c->moveSlot(c->first + i, c->first + i - 1);
+		}
+		c->count--;
+		size--;
+		if (c->count == 0)
+			unlinkChunk(c);
+		else if (c->count < ChunkCapacity / 4)
+		{
+			if (c->previousChunkPtr != nullptr && c->previousChunkPtr->count + c->count <= ChunkCapacity)
+				mergeWithNext(c->previousChunkPtr);
+			else
+				mergeWithNext(c);
+		}
+		return val;
+	}
+
+public:
+	/** Default list constructor, creates blank list*/
+	unrolled_list() = default;
+	/** Copy constructor, creates a copy of the other list*/
+	unrolled_list(const unrolled_list &otherList)
+	{
+		for (chunk *c = otherList.head; c != nullptr; c = c->nextChunkPtr)
+		{
+			for (size_t i = 0; i < c->count; i++)
+				push_back((*c)[i]);
+		}
+	}
+	/** Move constructor*/
+	unrolled_list(unrolled_list &&otherList) noexcept : head(otherList.head), tail(otherList.tail), size(otherList.size)
+	{
+		otherList.head = nullptr;
+		otherList.tail = nullptr;
+		otherList.size = 0;
+	}
+	/** Default list destructor*/
+	~unrolled_list() { clear(); }
+	/** Copy assignment operator
+	 * @param otherList - the list to copy the contents from
+	 * @return A reference to the current list with the copied contents
+	 */
+	unrolled_list &operator=(const unrolled_list &otherList)
+	{
+		if (this != &otherList)
+		{
+			clear();
+			for (chunk *c = otherList.head; c != nullptr; c = c->nextChunkPtr)
+			{
+				for (size_t i = 0; i < c->count; i++)
+					push_back((*c)[i]);
+			}
+		}
+		return *this;
+	}
+	/** Move assignment operator
+	 * @param otherList - the list to move the contents from
+	 * @return A reference to the current list with the moved contents
+	 */
+	unrolled_list &operator=(unrolled_list &&otherList) noexcept
+	{
+		if (this != &otherList)
+		{
+			clear();
+			head = otherList.head;
+			tail = otherList.tail;
+			size = otherList.size;
+			otherList.head = nullptr;
+			otherList.tail = nullptr;
+			otherList.size = 0;
+		}
+		return *this;
+	}
+
+	/** Method which allows to add element at the end of the list
+	 * @param elem - element to add
+	 */
+	void push_back(T elem)
+	{
+		if (tail == nullptr || tail->count == ChunkCapacity)
+			linkChunk(tail);
+		else if (tail->first + tail->count == ChunkCapacity)
+			tail->shiftTo(0);
+		new (tail->slotAt(tail->first + tail->count)) T(std::move(elem));
+		tail->count++;
+		size++;
+	}
+	/** Method which allows to add element at the beginning of the list
+	 * @param elem - element to add
+	 */
+	void push_front(T elem)
+	{
+		if (head == nullptr || head->count == ChunkCapacity)
+		{
+			linkChunk(nullptr);
+			head->first = ChunkCapacity;
+		}
+		else if (head->first == 0)
+			head->shiftTo(ChunkCapacity - head->count);
+		new (head->slotAt(head->first - 1)) T(std::move(elem));
+		head->first--;
+		head->count++;
+		size++;
+	}
+	/** Method which inserts element at given position, full chunk is split in two
+	 * @param position - position of the new element, from 0 to size
+	 * @param elem - element to add
+	 */
+	void insert_at(size_t position, T elem)
+	{
+		if (position > size)
+			throw myException(errorType::outOfRange);
+		if (position == size)
+		{
+			push_back(std::move(elem));
+			return;
+		}
+		size_t offset;
+		chunk *c = locate(position, offset);
+		if (c->count == ChunkCapacity)
+		{
+			// Upper half goes to a new chunk
+			chunk *upper = linkChunk(c);
+			size_t half = ChunkCapacity / 2;
+			for (size_t i = half; i < c->count; i++)
+			{
+				new (upper->slotAt(i - half)) T(std::move((*c)[i]));
+				(*c)[i].~T();
+			}
+			upper->count = c->count - half;
+			c->count = half;
+			if (offset >= half)
+			{
+				c = upper;
+				offset -= half;
+			}
+		}
+		if (c->first + c->count == ChunkCapacity)
+			c->shiftTo(c->first - 1);
+		for (size_t i = c->count; i > offset; i--)
+			c->moveSlot(c->first + i - 1, c->first + i);
+		new (c->slotAt(c->first + offset)) T(std::move(elem));
+		c->count++;
+		size++;
+	}
+	/** Returns contents of the last element in the list
+	 * @return Reference to the last element in the list
+	 */
+	T &back()
+	{
+		if (tail == nullptr)
+			throw myException();
+		return (*tail)[tail->count - 1];
+	}
+	/** Returns contents of the first element in the list
+	 * @return Reference to the first element in the list
+	 */
+	T &front()
+	{
+		if (head == nullptr)
+			throw myException();
+		return (*head)[0];
+	}
+	/** Returns element at given position, O(n / ChunkCapacity)
+	 * @param position - position of the element
+	 * @return Reference to the element
+	 */
+	T &at(size_t position)
+	{
+		if (position >= size)
+			throw myException(errorType::outOfRange);
+		size_t offset;
+		chunk *c = locate(position, offset);
+		return (*c)[offset];
+	}
+	/** Checks if the container is empty
+	 * @return true if the container is empty, false otherwise
+	 */
+	bool empty() { return head == nullptr; }
+	/** Returns the number of elements in the list
+	 * @return The number of elements in the list
+	 */
+	size_t getSize() { return size; }
+	/** Deletes element at the end of the list and returns it
+	 * @return Deleted element
+	 */
+	T pop_back()
+	{
+		if (tail == nullptr)
+			throw myException();
+		T val = std::move((*tail)[tail->count - 1]);
+		(*tail)[tail->count - 1].~T();
+		tail->count--;
+		size--;
+		if (tail->count == 0)
+			unlinkChunk(tail);
+		return val;
+	}
+	/** Deletes element at the beginning of the list and returns it
+	 * @return Deleted element
+	 */
+	T pop_front()
+	{
+		if (head == nullptr)
+			throw myException();
+		T val = std::move((*head)[0]);
+		(*head)[0].~T();
+		head->first++;
+		head->count--;
+		size--;
+		if (head->count == 0)
+			unlinkChunk(head);
+		return val;
+	}
+	/** Method which allows to pop element in a chosen position in the list
+	 * @param position - position of the element to pop
+	 * @return Deleted element
+	 */
+	T pop_specified_position(int position)
+	{
+		if (position < 0 || static_cast<size_t>(position) >= size)
+			throw myException(errorType::outOfRange);
+		size_t offset;
+		chunk *c = locate(static_cast<size_t>(position), offset);
+		return eraseFromChunk(c, offset);
+	}
+	/** Method displays all elements of the list*/
+	void display()
+	{
+		if (head == nullptr)
+		{
+			std::cout << "\t/Empty list!/" << std::endl;
+		}
+		else
+		{
+			for (chunk *c = head; c != nullptr; c = c->nextChunkPtr)
+			{
+				for (size_t i = 0; i < c->count; i++)
+					std::cout << (*c)[i] << '\n';
+			}
+			std::cout << std::flush;
+		}
+	}
+	/** Search for an element in the list
+	 * @param elem - the elements to search for
+	 */
+	void search(T elem)
+	{
+		int elemCounter = 0;
+		bool elemFound = false;
+		for (chunk *c = head; c != nullptr; c = c->nextChunkPtr)
+		{
+			for (size_t i = 0; i < c->count; i++, elemCounter++)
+			{
+				if (elem == (*c)[i])
+				{
+					std::cout << (*c)[i] << " at [" << elemCounter << "] position." << std::endl;
+					elemFound = true;
+				}
+			}
+		}
+		if (!elemFound)
+			std::cout << elem << " not found." << std::endl;
+	}
+	/** Sorts the elements in the list using operator< (stable)*/
+	void sort()
+	{
+		sort([](const T &a, const T &b)
+			 { return a < b; });
+	}
+	/** Sorts the elements in the list using given comparator. Elements are moved to a buffer,
+	 * sorted there and moved back, chunks keep their shape. Sort is stable.
+	 * @param comp - callable returning true if the first argument should go before the second one
+	 */
+	template <class Compare>
+	void sort(Compare comp)
+	{
+		std::vector<T> buffer;
+		buffer.reserve(size);
+		for (chunk *c = head; c != nullptr; c = c->nextChunkPtr)
+		{
+			for (size_t i = 0; i < c->count; i++)
+				buffer.push_back(std::move((*c)[i]));
+		}
+		std::stable_sort(buffer.begin(), buffer.end(), comp);
+		size_t next = 0;
+		for (chunk *c = head; c != nullptr; c = c->nextChunkPtr)
+		{
+			for (size_t i = 0; i < c->count; i++)
+				(*c)[i] = std::move(buffer[next++]);
+		}
+	}
+	/** Saves the contents of the list to a specified file
+	 * @param fileName The name of the file to save the list to
+	 */
+	void save(std::string fileName)
+	{
+		fileName += ".txt";
+		std::ofstream fileToSave(fileName);
+		if (!fileToSave)
+			throw myException();
+		for (chunk *c = head; c != nullptr; c = c->nextChunkPtr)
+		{
+			for (size_t i = 0; i < c->count; i++)
+				fileToSave << (*c)[i] << '\n';
+		}
+	}
+	/** Opens a list from a specified file, lines which cannot be parsed by listParser<T> are skipped
+	 * @param fileName The name of the file to open the list from
+	 */
+	void open(std::string fileName)
+	{
+		if (head != nullptr)
+			throw myException(errorType::nonEmptyList);
+		mappedFile file(fileName);
+		file.forEachLine([this](std::string_view line)
+						 {
+			T elem;
+			if (listParser<T>::parse(line, elem))
+				push_back(elem); });
+	}
+	/** Clears the memory by removing all elements and chunks*/
+	void clear()
+	{
+		while (head != nullptr)
+		{
+			chunk *temp = head;
+			head = head->nextChunkPtr;
+			for (size_t i = 0; i < temp->count; i++)
+				(*temp)[i].~T();
+			delete temp;
+		}
+		tail = nullptr;
+		size = 0;
+	}
+
+	/** Bidirectional iterator class, remembers chunk and position inside it*/
+	class iterator
+	{
+	public:
+		/** Constructor for an iterator object
+		 * @param _owner - list the iterator belongs to, used to step back from end()
+		 * @param c - chunk of the element, nullptr for end()
+		 * @param _offset - position of the element inside the chunk
+		 */
+		iterator(unrolled_list *_owner, chunk *c, size_t _offset) : owner(_owner), current(c), offset(_offset) {}
+		/** Dereference operator
+		 * @return Returns reference to the element
+		 */
+		T &operator*() { return (*current)[offset]; }
+		/** Increment operator - iterator is moved to the next element in the list
+		 * @return reference to the iterator
+		 */
+		iterator &operator++()
+		{
+			if (++offset == current->count)
+			{
+				current = current->nextChunkPtr;
+				offset = 0;
+			}
+			return *this;
+		}
+		/** Decrement operator - iterator is moved to the previous element in the list, end() can be decremented
+		 * @return reference to the iterator
+		 */
+		iterator &operator--()
+		{
+			if (current == nullptr)
+			{
+				current = owner->tail;
+				offset = current->count - 1;
+			}
+			else if (offset == 0)
+			{
+				current = current->previousChunkPtr;
+				offset = current->count - 1;
+			}
+			else
+				--offset;
+			return *this;
+		}
+		/** Equality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to the same element, false otherwise
+		 */
+		bool operator==(const iterator &other) { return current == other.current && offset == other.offset; }
+		/** Inequality operator
+		 * @param other - the other iterator to compare with
+		 * @return true if the iterators point to different elements, false otherwise
+		 */
+		bool operator!=(const iterator &other) { return !(*this == other); }
+
+	private:
+		unrolled_list *owner; /**< List the iterator belongs to*/
+		chunk *current;		  /**< Chunk of the element, nullptr for end()*/
+		size_t offset;		  /**< Position of the element inside the chunk*/
+	};
+
+	/** Returns an iterator pointing to the first element of the list
+	 * @return Iterator pointing to the first element of the list
+	 */
+	iterator begin() { return iterator(this, head, 0); }
+	/** Returns an iterator pointing to the end of the list
+	 * @return Iterator pointing to the end of the list
+	 */
+	iterator end() { return iterator(this, nullptr, 0); }
+};
+
+#endif /* UNROLLED_LIST_H */